@@ -1,101 +1,218 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "SA_algorithm.h"
+#include "SA_internal.h"
+#include "energy.h"
+#include "presolve.h"
+#include "bitsolver.h"
 
-typedef struct {
-    int **grid; // aktualna plansza Sudoku
-    int energy; // energia - ilosc konfliktów
-    int size; // rozmiar planszy
-    int box_size; // rozmiar pojedynczego podkwadratu
-} SudokuState;
+#define SA_EXCHANGE_INTERVAL 1000 // liczba iteracji między wymianami replik
+#define SA_LADDER_MAX 4.0 // stosunek temperatury najgorętszego łańcucha do najzimniejszego
+#define SA_CALIBRATION_MOVES 200 // liczba próbnych ruchów przy kalibracji temperatury początkowej
+#define SA_FINISH_NODES 20000 // limit węzłów solvera dokładnego na jedną próbę dokończenia planszy
+#define SA_DEADLINE_CHECK_STEPS 1024 // co ile iteracji odczytywany jest zegar, gdy wyżarzanie ma termin
+#define SA_UNTIL_MAX_ITERATIONS 50000000L // limit iteracji solve_sudoku_sa_until wywołanej bez terminu i bez flagi przerwania
 
 /**
  * Funkcja oblicza energię planszy Sudoku.
  * Energia to liczba powtórzeń cyfr w wierszach, kolumnach i blokach.
- * @param grid - tablica Sudoku
+ * Liczona maskami bitowymi przez wspólne jądro z energy.c (AVX2 lub wersja skalarna).
+ * @param grid - ciągła tablica Sudoku (wierszami)
  * @param size - rozmiar planszy
  * @return wartość energii 
  */
-int calculate_energy(int **grid, int size) {
-    int energy = 0;
-    int box_size = (int)sqrt(size);
+int calculate_energy(const uint8_t *grid, int size) {
+    return boardEnergy(grid, size);
+}
+
+/**
+ * Funkcja przelicza od zera liczniki cyfr w wierszach i kolumnach stanu.
+ * @param state - struktura stanu Sudoku
+ */
+void init_counts(SudokuState *state) {
+    int size = state->size;
+    memset(state->row_count, 0, size * (size + 1));
+    memset(state->col_count, 0, size * (size + 1));
 
-    // Sprawdzenie wierszy i kolumn
     for (int i = 0; i < size; i++) {
-        int *row_count = calloc(size + 1, sizeof(int));
-        int *col_count = calloc(size + 1, sizeof(int));
-        
         for (int j = 0; j < size; j++) {
-            if (grid[i][j] != 0) row_count[grid[i][j]]++;
-            if (grid[j][i] != 0) col_count[grid[j][i]]++;
-        }
-        // Zliczanie powtórzeń
-        for (int k = 1; k <= size; k++) {
-            if (row_count[k] > 1) energy += row_count[k] - 1;
-            if (col_count[k] > 1) energy += col_count[k] - 1;
+            int val = state->grid[i * size + j];
+            if (val != 0) {
+                state->row_count[i * (size + 1) + val]++;
+                state->col_count[j * (size + 1) + val]++;
+            }
         }
+    }
+}
+
+/**
+ * Funkcja zwraca zmianę energii jednej jednostki (wiersza lub kolumny),
+ * gdy wartość a zostaje w niej zastąpiona wartością b.
+ * @param count - liczniki cyfr tej jednostki
+ * @param a - wartość usuwana
+ * @param b - wartość wstawiana
+ * @return zmiana energii jednostki
+ */
+static int unit_delta(const uint8_t *count, int a, int b) {
+    if (a == b) return 0;
+    int delta = 0;
+    if (count[a] > 1) delta--; // usunięcie a likwiduje jedno powtórzenie
+    if (count[b] > 0) delta++; // wstawienie b tworzy nowe powtórzenie
+    return delta;
+}
+
+/**
+ * Funkcja liczy zmianę energii po zamianie komórek (r1,c1) i (r2,c2).
+ * Zamiana odbywa się wewnątrz jednego bloku, więc energia bloków się nie zmienia
+ * - wystarczy sprawdzić dwa wiersze i dwie kolumny.
+ * Rozmiar jest parametrem, aby jądra dla typowych rozmiarów dostały go jako stałą.
+ * @param state - struktura stanu Sudoku (przed zamianą)
+ * @param size - rozmiar planszy
+ * @return zmiana energii
+ */
+static inline int swap_delta_sized(const SudokuState *state, int r1, int c1, int r2, int c2, const int size) {
+    int stride = size + 1;
+    int a = state->grid[r1 * size + c1];
+    int b = state->grid[r2 * size + c2];
+    int delta = 0;
 
-        free(row_count);
-        free(col_count);
+    if (r1 != r2) {
+        delta += unit_delta(&state->row_count[r1 * stride], a, b);
+        delta += unit_delta(&state->row_count[r2 * stride], b, a);
     }
+    if (c1 != c2) {
+        delta += unit_delta(&state->col_count[c1 * stride], a, b);
+        delta += unit_delta(&state->col_count[c2 * stride], b, a);
+    }
+    return delta;
+}
 
-    // Sprawdzenie bloków
-    for (int block = 0; block < size; block++) {
-        int *block_count = calloc(size + 1, sizeof(int));
-        int row_start = (block / box_size) * box_size;
-        int col_start = (block % box_size) * box_size;
+/**
+ * Funkcja liczy zmianę energii po zamianie komórek (r1,c1) i (r2,c2).
+ * @param state - struktura stanu Sudoku (przed zamianą)
+ * @return zmiana energii
+ */
+int swap_delta(const SudokuState *state, int r1, int c1, int r2, int c2) {
+    return swap_delta_sized(state, r1, c1, r2, c2, state->size);
+}
+
+/**
+ * Funkcja zamienia wartości komórek (r1,c1) i (r2,c2) i aktualizuje liczniki.
+ * @param state - struktura stanu Sudoku
+ * @param size - rozmiar planszy
+ */
+static inline void apply_swap_sized(SudokuState *state, int r1, int c1, int r2, int c2, const int size) {
+    int stride = size + 1;
+    uint8_t *p1 = &state->grid[r1 * size + c1];
+    uint8_t *p2 = &state->grid[r2 * size + c2];
+    int a = *p1;
+    int b = *p2;
+
+    state->row_count[r1 * stride + a]--;
+    state->row_count[r1 * stride + b]++;
+    state->row_count[r2 * stride + b]--;
+    state->row_count[r2 * stride + a]++;
+    state->col_count[c1 * stride + a]--;
+    state->col_count[c1 * stride + b]++;
+    state->col_count[c2 * stride + b]--;
+    state->col_count[c2 * stride + a]++;
+
+    *p1 = (uint8_t)b;
+    *p2 = (uint8_t)a;
+}
+
+/**
+ * Funkcja zamienia wartości komórek (r1,c1) i (r2,c2) i aktualizuje liczniki.
+ * @param state - struktura stanu Sudoku
+ */
+void apply_swap(SudokuState *state, int r1, int c1, int r2, int c2) {
+    apply_swap_sized(state, r1, c1, r2, c2, state->size);
+}
 
+/**
+ * Funkcja alokuje pamięć dla stanu Sudoku (plansza i liczniki w jednym bloku).
+ * @param state - struktura stanu Sudoku
+ * @param size - rozmiar planszy
+ */
+void alloc_state(SudokuState *state, int size) {
+    int bytes = size * size + 2 * size * (size + 1) + 2 * size * size;
+    bytes += bytes & 1; // wyrównanie block_start do uint16_t
+    state->size = size;
+    state->box_size = boardBoxSize(size);
+    state->energy = 0;
+    state->grid = malloc(bytes + (size + 1) * sizeof(uint16_t));
+    state->row_count = state->grid + size * size;
+    state->col_count = state->row_count + size * (size + 1);
+    state->free_cells = (uint8_t (*)[2])(state->col_count + size * (size + 1));
+    state->block_start = (uint16_t *)(state->grid + bytes);
+    state->movable_blocks = 0;
+}
+
+/**
+ * Funkcja buduje tablice zmiennych pól: dla każdego bloku z co najmniej dwoma
+ * zmiennymi polami zapisuje ich współrzędne. Pola stałe nie zmieniają się w trakcie
+ * rozwiązywania, więc tablice liczone są raz, a nie przy każdym ruchu.
+ * @param state - struktura stanu Sudoku
+ * @param initial - plansza z oznaczeniem pól stałych
+ */
+static void build_move_tables(SudokuState *state, const Board *initial) {
+    int size = state->size, box_size = state->box_size;
+    int count = 0;
+    state->movable_blocks = 0;
+    state->block_start[0] = 0;
+    for (int block = 0; block < size; block++) {
+        int r0 = (block / box_size) * box_size;
+        int c0 = (block % box_size) * box_size;
+        int start = count;
         for (int i = 0; i < box_size; i++) {
             for (int j = 0; j < box_size; j++) {
-                int val = grid[row_start + i][col_start + j];
-                if (val != 0) block_count[val]++;
+                if (!isFixedCell(initial, (r0 + i) * size + c0 + j)) {
+                    state->free_cells[count][0] = (uint8_t)(r0 + i);
+                    state->free_cells[count][1] = (uint8_t)(c0 + j);
+                    count++;
+                }
             }
         }
-
-        for (int k = 1; k <= size; k++) {
-            if (block_count[k] > 1) energy += block_count[k] - 1;
+        if (count - start < 2) {
+            count = start; // blok bez możliwej zamiany jest pomijany
+            continue;
         }
-
-        free(block_count);
+        state->block_start[++state->movable_blocks] = (uint16_t)count;
     }
-
-    return energy;
 }
 
 /**
- * Funkcja inicjalizuje stan Sudoku.
+ * Funkcja inicjalizuje stan Sudoku (pamięć musi być zaalokowana przez alloc_state).
  * Wypełnia każdą wolną komórkę w bloku losową wartością z dozwolonych.
  * @param state - struktura stanu Sudoku
- * @param initial - początkowa plansza
- * @param fixed - tablica oznaczająca stałe liczby
- * @param size - rozmiar planszy
+ * @param initial - początkowa plansza wraz z oznaczeniem pól stałych
+ * @param rng - generator liczb losowych
  */
-void initialize_state(SudokuState *state, int **initial, int **fixed, int size) {
+void initialize_state(SudokuState *state, const Board *initial, Rng *rng) {
+    int size = initial->size;
     state->size = size;
-    state->box_size = (int)sqrt(size);
-    state->grid = malloc(size * sizeof(int *));
-    
-    for (int i = 0; i < size; i++) {
-        state->grid[i] = malloc(size * sizeof(int));
-        memcpy(state->grid[i], initial[i], size * sizeof(int));
-    }
+    state->box_size = initial->box_size;
+
+    memcpy(state->grid, initial->cells, size * size);
     // Dla każdego bloku wypełnij brakujące liczby
     for (int block = 0; block < size; block++) {
-        int *used = calloc(size + 1, sizeof(int));
-        int cells[size][2];
-        int count = 0;
+        uint8_t used[size + 1];
+        memset(used, 0, sizeof(used));
 
         int row_start = (block / state->box_size) * state->box_size;
         int col_start = (block % state->box_size) * state->box_size;
         // Zaznacz już użyte liczby
         for (int i = 0; i < state->box_size; i++) {
             for (int j = 0; j < state->box_size; j++) {
-                int r = row_start + i, c = col_start + j;
-                if (fixed[r][c]) {
-                    used[initial[r][c]] = 1;
+                int idx = (row_start + i) * size + col_start + j;
+                if (isFixedCell(initial, idx)) {
+                    used[initial->cells[idx]] = 1;
                 }
             }
         }
@@ -103,152 +220,1077 @@ void initialize_state(SudokuState *state, int **initial, int **fixed, int size)
         for (int num = 1; num <= size; num++) {
             if (!used[num]) {
                 while (1) {
-                    int r = row_start + rand() % state->box_size;
-                    int c = col_start + rand() % state->box_size;
-                    if (!fixed[r][c] && state->grid[r][c] == 0) {
-                        state->grid[r][c] = num;
+                    int r = row_start + rngBounded(rng, state->box_size);
+                    int c = col_start + rngBounded(rng, state->box_size);
+                    int idx = r * size + c;
+                    if (!isFixedCell(initial, idx) && state->grid[idx] == 0) {
+                        state->grid[idx] = (uint8_t)num;
                         break;
                     }
                 }
             }
         }
-        free(used);
     }
 
+    init_counts(state);
     state->energy = calculate_energy(state->grid, size);
+    build_move_tables(state, initial);
 }
 
 /**
- * Funkcja kopiuje stan Sudoku.
- * @param dest - miejsce docelowe
- * @param src - źródło
+ * Funkcja proponuje ruch - zamianę dwóch zmiennych komórek w tym samym bloku.
+ * Stan nie jest modyfikowany: zwracana jest tylko zmiana energii, a ruch
+ * wykonuje się przez apply_swap dopiero po akceptacji (odrzucenie nic nie kosztuje).
+ * Blok losowany jest tylko spośród bloków z ruchami, a para pól wprost z tablicy
+ * zmiennych pól bloku (bez ponawiania losowania).
+ * @param current - obecny stan
+ * @param move - wylosowany ruch wraz ze zmianą energii
+ * @param rng - generator liczb losowych
+ * @param size - rozmiar planszy
+ * @return 1 jeśli udało się wylosować ruch, 0 jeśli żaden blok nie ma dwóch zmiennych komórek
  */
-void copy_state(SudokuState *dest, const SudokuState *src) {
-    dest->size = src->size;
-    dest->box_size = src->box_size;
-    dest->energy = src->energy;
-    
-    for (int i = 0; i < src->size; i++) {
-        memcpy(dest->grid[i], src->grid[i], src->size * sizeof(int));
-    }
+static inline int generate_neighbor_sized(const SudokuState *current, SwapMove *move, Rng *rng, const int size) {
+    if (current->movable_blocks == 0)
+        return 0;
+    int k = current->movable_blocks == 1 ? 0 : rngBounded(rng, current->movable_blocks);
+    int start = current->block_start[k];
+    int count = current->block_start[k + 1] - start;
+
+    // Druga komórka losowana spośród pozostałych count - 1
+    int a = rngBounded(rng, count);
+    int b = rngBounded(rng, count - 1);
+    b += b >= a;
+
+    const uint8_t *first = current->free_cells[start + a];
+    const uint8_t *second = current->free_cells[start + b];
+    move->r1 = first[0];
+    move->c1 = first[1];
+    move->r2 = second[0];
+    move->c2 = second[1];
+    // Zmiana energii liczona przyrostowo z dwóch wierszy i dwóch kolumn
+    move->delta = swap_delta_sized(current, move->r1, move->c1, move->r2, move->c2, size);
+    return 1;
 }
 
 /**
- * Funkcja generuje sąsiada poprzez zamianę dwóch zmiennych komórek w tym samym bloku.
- * @param neighbor - nowy stan
- * @param current - obecny stan
- * @param fixed - tablica stałych wartości
+ * Funkcja proponuje ruch - zamianę dwóch zmiennych komórek w tym samym bloku.
+ * @param current - obecny stan (po initialize_state)
+ * @param move - wylosowany ruch wraz ze zmianą energii
+ * @param rng - generator liczb losowych
+ * @return 1 jeśli udało się wylosować ruch, 0 jeśli żaden blok nie ma dwóch zmiennych komórek
  */
-void generate_neighbor(SudokuState *neighbor, const SudokuState *current, int **fixed) {
-    copy_state(neighbor, current);
+int generate_neighbor(const SudokuState *current, SwapMove *move, Rng *rng) {
+    return generate_neighbor_sized(current, move, rng, current->size);
+}
 
-    int block = rand() % current->size;
-    int r0 = (block / current->box_size) * current->box_size;
-    int c0 = (block % current->box_size) * current->box_size;
+/**
+ * Funkcja zwalnia pamięć zaalokowaną dla stanu Sudoku.
+ * @param state - struktura do zwolnienia
+ */
+void free_state(SudokuState *state) {
+    free(state->grid);
+}
 
-    int candidates[current->size][2];
-    int count = 0;
-    // Zbierz współrzędne niezamrożonych komórek w bloku
-    for (int i = 0; i < current->box_size; i++) {
-        for (int j = 0; j < current->box_size; j++) {
-            int r = r0 + i, c = c0 + j;
-            if (!fixed[r][c]) {
-                candidates[count][0] = r;
-                candidates[count][1] = c;
-                count++;
+
+/**
+ * Funkcja przygotowuje łańcuch wyżarzania: alokuje stan, losowo go wypełnia
+ * i zapisuje jako dotychczas najlepszy.
+ * @param chain - łańcuch do zainicjalizowania
+ * @param board - początkowa plansza z polami stałymi
+ * @param seed - ziarno bazowe generatora liczb losowych
+ * @param stream - numer strumienia generatora (różny dla każdego łańcucha)
+ */
+void chain_init(SAChain *chain, const Board *board, uint64_t seed, uint64_t stream) {
+    int size = board->size;
+    alloc_state(&chain->current, size);
+    chain->best = malloc(size * size);
+    chain_reset(chain, board, seed, stream);
+}
+
+/**
+ * Funkcja ponownie przygotowuje zainicjalizowany łańcuch dla nowej planszy tego samego
+ * rozmiaru, bez alokacji pamięci (łańcuch może obsłużyć wiele zagadek po kolei).
+ * @param chain - łańcuch po chain_init
+ * @param board - początkowa plansza z polami stałymi
+ * @param seed - ziarno bazowe generatora liczb losowych
+ * @param stream - numer strumienia generatora
+ */
+void chain_reset(SAChain *chain, const Board *board, uint64_t seed, uint64_t stream) {
+    int size = board->size;
+    rngSeedStream(&chain->rng, seed, stream);
+    initialize_state(&chain->current, board, &chain->rng);
+    memcpy(chain->best, chain->current.grid, size * size);
+    chain->best_energy = chain->current.energy;
+    chain->best_pending = 0;
+    chain->iterations = 0;
+    chain->accepted = 0;
+    chain->rejected = 0;
+    chain->uphill = 0;
+    chain->finish_attempts = 0;
+    chain->finished_exact = 0;
+}
+
+/**
+ * Funkcja wykonuje jedną iterację wyżarzania w temperaturze T.
+ * Ruch jest wykonywany w miejscu, a najlepsza plansza kopiowana leniwie - dopiero
+ * gdy łańcuch ma opuścić niezapisane minimum ruchem pod górę.
+ * @param chain - łańcuch wyżarzania
+ * @param T - aktualna temperatura
+ * @param size - rozmiar planszy
+ */
+static inline void chain_step(SAChain *chain, double T, const int size) {
+    SwapMove move;
+    if (!generate_neighbor_sized(&chain->current, &move, &chain->rng, size))
+        return;
+
+    int delta = move.delta;
+    // Warunek akceptacji (przyjmuje gorsze rozwiązanie z pewnym prawdopodobieństwem)
+    if (delta < 0 || (exp(-delta / T) > rngDouble(&chain->rng))) {
+        chain->accepted++;
+        if (delta > 0) {
+            chain->uphill++;
+            // Przed wyjściem z niezapisanego minimum pod górę zapisz je
+            if (chain->best_pending) {
+                memcpy(chain->best, chain->current.grid, size * size);
+                chain->best_pending = 0;
             }
         }
+        apply_swap_sized(&chain->current, move.r1, move.c1, move.r2, move.c2, size);
+        chain->current.energy += delta;
+        if (chain->current.energy < chain->best_energy) {
+            chain->best_energy = chain->current.energy;
+            chain->best_pending = 1;
+        }
+    } else {
+        chain->rejected++;
+    }
+}
+
+/**
+ * Funkcja wykonuje do steps iteracji wyżarzania z chłodzeniem geometrycznym.
+ * Kończy wcześniej, gdy łańcuch znajdzie energię 0, temperatura spadnie do T_end
+ * lub zostanie ustawiona flaga stop.
+ * @param chain - łańcuch wyżarzania
+ * @param T - temperatura bazowa, aktualizowana po każdej iteracji
+ * @param scale - mnożnik temperatury łańcucha (drabina temperatur)
+ * @param alpha - współczynnik chłodzenia
+ * @param T_end - temperatura końcowa
+ * @param steps - maksymalna liczba iteracji
+ * @param stop - wspólna flaga przerwania (NULL - brak)
+ * @param size - rozmiar planszy
+ * @return liczba wykonanych iteracji
+ */
+static inline __attribute__((always_inline)) int chain_steps(SAChain *chain, double *T, double scale, double alpha,
+                                                             double T_end, int steps, atomic_int *stop,
+                                                             const int size) {
+    double t = *T;
+    int done = 0;
+    while (done < steps && t > T_end && chain->best_energy > 0) {
+        if (stop && atomic_load_explicit(stop, memory_order_relaxed))
+            break;
+        chain_step(chain, t * scale, size);
+        t *= alpha;
+        done++;
     }
-    // Jeśli są przynajmniej dwie zmienne komórki, zamień je miejscami
-    if (count >= 2) {
-        int a = rand() % count, b;
-        do {
-            b = rand() % count;
-        } while (a == b);
+    *T = t;
+    chain->iterations += done;
+    return done;
+}
 
-        int r1 = candidates[a][0], c1 = candidates[a][1];
-        int r2 = candidates[b][0], c2 = candidates[b][1];
-        // Zamiana dwóch wartości
-        int tmp = neighbor->grid[r1][c1];
-        neighbor->grid[r1][c1] = neighbor->grid[r2][c2];
-        neighbor->grid[r2][c2] = tmp;
-        // Oblicz nową energię
-        neighbor->energy = calculate_energy(neighbor->grid, neighbor->size);
+typedef int (*SAKernel)(SAChain *chain, double *T, double scale, double alpha, double T_end, int steps,
+                        atomic_int *stop);
+
+// Jądra wyspecjalizowane dla typowych rozmiarów: stały rozmiar pozwala kompilatorowi
+// rozwinąć pętle po wierszach i kolumnach i zamienić mnożenia indeksów na stałe
+#define SA_KERNEL(N)                                                                                             \
+    static int sa_kernel_##N(SAChain *chain, double *T, double scale, double alpha, double T_end, int steps,    \
+                             atomic_int *stop) {                                                                 \
+        return chain_steps(chain, T, scale, alpha, T_end, steps, stop, N);                                       \
     }
+SA_KERNEL(4)
+SA_KERNEL(9)
+SA_KERNEL(16)
+SA_KERNEL(25)
+SA_KERNEL(36)
+
+/**
+ * Jądro dla dowolnego rozmiaru (rozmiar odczytywany ze stanu łańcucha)
+ */
+static int sa_kernel_any(SAChain *chain, double *T, double scale, double alpha, double T_end, int steps,
+                         atomic_int *stop) {
+    return chain_steps(chain, T, scale, alpha, T_end, steps, stop, chain->current.size);
 }
 
 /**
- * Funkcja zwalnia pamięć zaalokowaną dla stanu Sudoku.
- * @param state - struktura do zwolnienia
+ * Funkcja wybiera jądro wyżarzania dla rozmiaru planszy.
+ * @param size - rozmiar planszy
+ * @return jądro wyspecjalizowane lub ogólne
  */
-void free_state(SudokuState *state) {
-    for (int i = 0; i < state->size; i++) {
-        free(state->grid[i]);
+static SAKernel select_kernel(int size) {
+    switch (size) {
+    case 4: return sa_kernel_4;
+    case 9: return sa_kernel_9;
+    case 16: return sa_kernel_16;
+    case 25: return sa_kernel_25;
+    case 36: return sa_kernel_36;
+    default: return sa_kernel_any;
     }
-    free(state->grid);
 }
 
 /**
- * Główna funkcja wykonująca optymalizację symulowanym wyżarzaniem.
- * Szuka stanu planszy o minimalnej energii.
- * @param initial - początkowa plansza
- * @param fixed - tablica stałych wartości
- * @param size - rozmiar planszy
+ * Funkcja pobiera najstarszą próbkę z bufora (strona konsumenta).
+ * @param ring - bufor próbek
+ * @param sample - miejsce na próbkę
+ * @return 1 jeśli pobrano próbkę, 0 jeśli bufor jest pusty
+ */
+int sa_ring_pop(SASampleRing *ring, SASample *sample) {
+    unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned long head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail == head)
+        return 0;
+    *sample = ring->items[tail % SA_RING_CAPACITY];
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+/**
+ * Funkcja dopisuje próbkę do bufora (strona producenta); przy pełnym buforze próbka przepada.
+ * @param ring - bufor próbek
+ * @param sample - próbka
+ */
+static void sa_ring_push(SASampleRing *ring, const SASample *sample) {
+    unsigned long head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= SA_RING_CAPACITY) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    ring->items[head % SA_RING_CAPACITY] = *sample;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+/**
+ * Funkcja przekazuje próbkę stanu łańcucha do monitora.
+ * @param monitor - monitor przebiegu
+ * @param chain - łańcuch wyżarzania
+ * @param T - aktualna temperatura łańcucha
+ */
+static void sa_emit_sample(const SAMonitor *monitor, const SAChain *chain, double T) {
+    SASample sample = {chain->iterations, T, chain->current.energy, chain->best_energy};
+    if (monitor->callback)
+        monitor->callback(&sample, monitor->user);
+    if (monitor->ring)
+        sa_ring_push(monitor->ring, &sample);
+    if (monitor->verbose)
+        printf("Iteracja: %ld, T: %.4f, Energia: %d\n", sample.iteration, T, sample.best_energy);
+}
+
+/**
+ * Funkcja wykonuje do steps iteracji jądrem wyżarzania, dzieląc je na porcje kończące się
+ * na wielokrotnościach monitor->interval, po których pobierana jest próbka. Bez monitora
+ * jądro wywoływane jest raz, więc próbkowanie nie kosztuje nic w pętli wyżarzania.
+ * Pozostałe parametry jak w chain_steps.
+ * @param kernel - jądro wyżarzania
+ * @param monitor - monitor przebiegu (NULL - brak)
+ * @return liczba wykonanych iteracji
+ */
+static int run_sampled(SAKernel kernel, SAChain *chain, double *T, double scale, double alpha, double T_end, int steps,
+                       atomic_int *stop, const SAMonitor *monitor) {
+    if (monitor == NULL || monitor->interval <= 0)
+        return kernel(chain, T, scale, alpha, T_end, steps, stop);
+    int done = 0;
+    while (done < steps) {
+        int chunk = monitor->interval - (int)(chain->iterations % monitor->interval);
+        if (chunk > steps - done)
+            chunk = steps - done;
+        int ran = kernel(chain, T, scale, alpha, T_end, chunk, stop);
+        done += ran;
+        if (ran > 0 && chain->iterations % monitor->interval == 0)
+            sa_emit_sample(monitor, chain, *T * scale);
+        if (ran < chunk)
+            break; // jądro zakończyło wcześniej (rozwiązanie, T_end lub stop)
+    }
+    return done;
+}
+
+/**
+ * Funkcja wyznacza termin odległy o seconds sekund od chwili obecnej (CLOCK_MONOTONIC).
+ * @param deadline - wynik
+ * @param seconds - czas do terminu
+ */
+static void deadline_after(struct timespec *deadline, double seconds) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    long nanos = deadline->tv_nsec + (long)((seconds - (long)seconds) * 1e9);
+    deadline->tv_sec += (long)seconds + nanos / 1000000000;
+    deadline->tv_nsec = nanos % 1000000000;
+}
+
+/**
+ * Funkcja sprawdza, czy minął termin (CLOCK_MONOTONIC).
+ * @param deadline - termin (NULL - brak)
+ * @return 1 po terminie
+ */
+static int deadline_passed(const struct timespec *deadline) {
+    return deadline != NULL && seconds_since(deadline) >= 0;
+}
+
+/**
+ * Funkcja wykonuje steps iteracji w stałej temperaturze (run_sampled). Z terminem iteracje
+ * idą porcjami po SA_DEADLINE_CHECK_STEPS, a zegar odczytywany jest tylko między porcjami
+ * (jądro w każdej iteracji sprawdza tylko flagę stop).
+ * @param deadline - termin (NULL - brak, jedno wywołanie jądra)
+ * Pozostałe parametry jak w run_sampled.
+ * @return liczba wykonanych iteracji
+ */
+static int run_until(SAKernel kernel, SAChain *chain, double *T, int steps, atomic_int *stop,
+                     const struct timespec *deadline, const SAMonitor *monitor) {
+    if (deadline == NULL)
+        return run_sampled(kernel, chain, T, 1.0, 1.0, 0.0, steps, stop, monitor);
+    int done = 0;
+    while (done < steps && !deadline_passed(deadline)) {
+        int chunk = steps - done < SA_DEADLINE_CHECK_STEPS ? steps - done : SA_DEADLINE_CHECK_STEPS;
+        int ran = run_sampled(kernel, chain, T, 1.0, 1.0, 0.0, chunk, stop, monitor);
+        done += ran;
+        if (ran < chunk)
+            break; // rozwiązanie lub stop
+    }
+    return done;
+}
+
+/**
+ * Funkcja dodaje liczniki łańcucha do statystyk.
+ * @param chain - łańcuch wyżarzania
+ * @param stats - statystyki
+ */
+void chain_add_stats(const SAChain *chain, SAStats *stats) {
+    stats->iterations += chain->iterations;
+    stats->accepted += chain->accepted;
+    stats->rejected += chain->rejected;
+    stats->uphill += chain->uphill;
+    stats->finish_attempts += chain->finish_attempts;
+}
+
+/**
+ * Funkcja zapisuje niezapisane minimum (aktualny stan wciąż ma wtedy energię best_energy).
+ * @param chain - łańcuch wyżarzania
+ */
+void chain_flush_best(SAChain *chain) {
+    if (chain->best_pending) {
+        memcpy(chain->best, chain->current.grid, chain->current.size * chain->current.size);
+        chain->best_pending = 0;
+    }
+}
+
+/**
+ * Funkcja zwalnia pamięć łańcucha wyżarzania.
+ * @param chain - łańcuch do zwolnienia
+ */
+void chain_free(SAChain *chain) {
+    free_state(&chain->current);
+    free(chain->best);
+}
+
+/**
+ * Funkcja prowadzi zainicjalizowany łańcuch według geometrycznego schematu chłodzenia.
+ * @param chain - łańcuch wyżarzania (po chain_init)
  * @param T_start - temperatura początkowa
  * @param T_end - temperatura końcowa
  * @param alpha - współczynnik chłodzenia
  * @param max_iterations - maksymalna liczba iteracji
+ * @param monitor - próbkowanie przebiegu (NULL - brak)
+ * @return liczba wykonanych iteracji
  */
-void solve_sudoku_sa(int **initial, int **fixed, int size, double T_start, double T_end, double alpha, int max_iterations) {
-    srand(time(NULL));
+int sa_run(SAChain *chain, double T_start, double T_end, double alpha, int max_iterations, const SAMonitor *monitor) {
+    SAKernel kernel = select_kernel(chain->current.size);
+    double T = T_start;
+    int iteration = run_sampled(kernel, chain, &T, 1.0, alpha, T_end, max_iterations, NULL, monitor);
+    chain_flush_best(chain);
+    return iteration;
+}
 
-    SudokuState current, neighbor, best;
-    
-    // Alokacja pamięci
-    current.grid = malloc(size * sizeof(int *));
-    neighbor.grid = malloc(size * sizeof(int *));
-    best.grid = malloc(size * sizeof(int *));
-    for (int i = 0; i < size; i++) {
-        current.grid[i] = malloc(size * sizeof(int));
-        neighbor.grid[i] = malloc(size * sizeof(int));
-        best.grid[i] = malloc(size * sizeof(int));
+/**
+ * Funkcja szacuje temperaturę początkową jako odchylenie standardowe zmian energii
+ * losowych ruchów ze stanu początkowego (ruchy nie są wykonywane).
+ * @param chain - łańcuch wyżarzania
+ * @return temperatura początkowa
+ */
+double sa_calibrate_temperature(SAChain *chain) {
+    double sum = 0, sum_sq = 0;
+    int samples = 0;
+    for (int k = 0; k < SA_CALIBRATION_MOVES; k++) {
+        SwapMove move;
+        if (!generate_neighbor(&chain->current, &move, &chain->rng))
+            continue;
+        sum += move.delta;
+        sum_sq += (double)move.delta * move.delta;
+        samples++;
     }
-    // Inicjalizacja
-    initialize_state(&current, initial, fixed, size);
-    copy_state(&best, &current);
+    if (samples < 2)
+        return 1.0;
+    double mean = sum / samples;
+    double variance = sum_sq / samples - mean * mean;
+    return variance > 0 ? sqrt(variance) : 1.0;
+}
 
-    double T = T_start;
+/**
+ * Funkcja prowadzi łańcuch adaptacyjnym schematem chłodzenia:
+ * - temperatura początkowa T0 to odchylenie standardowe zmian energii próbnych ruchów,
+ * - temperatura jest stała w obrębie epoki (liczba ruchów proporcjonalna do liczby
+ *   zmiennych pól) i maleje dopiero po epoce,
+ * - po SA_STAGNATION_EPOCHS epokach bez poprawy łańcuch jest podgrzewany w miejscu
+ *   do SA_REHEAT_FRACTION * T0, a po SA_MAX_REHEATS nieudanych podgrzaniach startuje
+ *   od nowego losowego wypełnienia (najlepsza plansza zostaje w chain->best).
+ *   Powrót do najlepszego stanu dawał mniej rozwiązań - minimum lokalne z energią 2
+ *   zwykle leży w złym basenie.
+ * W trybie hybrydowym plateau z niską energią (nie większą niż rozmiar planszy) kończy
+ * się próbą dokończenia planszy solverem dokładnym (sa_exact_finish) z limitem
+ * SA_FINISH_NODES węzłów na próbę; węzły solvera nie pomniejszają budżetu iteracji wyżarzania.
+ * @param chain - łańcuch wyżarzania (po chain_init)
+ * @param board - plansza z oznaczeniem pól stałych
+ * @param max_iterations - maksymalna liczba iteracji
+ * @param stop - wspólna flaga przerwania (NULL - brak)
+ * @param deadline - termin CLOCK_MONOTONIC, po którym wyżarzanie kończy się z najlepszą planszą (NULL - brak)
+ * @param monitor - próbkowanie przebiegu (NULL - brak)
+ * @param hybrid - 1 jeśli plateau ma być dokańczane solverem dokładnym
+ * @return liczba wykonanych iteracji wyżarzania
+ */
+int sa_run_adaptive(SAChain *chain, const Board *board, int max_iterations, atomic_int *stop,
+                    const struct timespec *deadline, const SAMonitor *monitor, int hybrid) {
+    int size = chain->current.size;
+    SAKernel kernel = select_kernel(size);
+    int free_cells = 0;
+    for (int idx = 0; idx < size * size; idx++)
+        free_cells += !isFixedCell(board, idx);
+    int epoch_length = free_cells * SA_EPOCH_MOVES_PER_CELL;
+    if (epoch_length < 1) epoch_length = 1;
+
+    double T0 = sa_calibrate_temperature(chain);
+    double T = T0;
     int iteration = 0;
-    // Pętla SA
-    while (T > T_end && best.energy > 0 && iteration < max_iterations) {
-        generate_neighbor(&neighbor, &current, fixed);
-
-        int delta = neighbor.energy - current.energy;
-        // Warunek akceptacji (przyjmuje gorsze rozwiązanie z pewnym prawdopodobieństwem)
-        if (delta < 0 || (exp(-delta / T) > (double)rand() / RAND_MAX)) {
-            copy_state(&current, &neighbor);
-            if (current.energy < best.energy) {
-                copy_state(&best, &current);
+    int stagnant = 0, reheats = 0;
+    int run_best = chain->current.energy; // najniższa energia na końcu epoki od ostatniego podgrzania
+
+    while (chain->best_energy > 0 && iteration < max_iterations) {
+        if ((stop && atomic_load_explicit(stop, memory_order_relaxed)) || deadline_passed(deadline))
+            break;
+        int steps = max_iterations - iteration;
+        if (steps > epoch_length)
+            steps = epoch_length;
+        double t = T; // w epoce temperatura się nie zmienia (alpha = 1)
+        iteration += run_until(kernel, chain, &t, steps, stop, deadline, monitor);
+        T *= SA_EPOCH_ALPHA;
+
+        if (chain->current.energy < run_best) {
+            run_best = chain->current.energy;
+            stagnant = 0;
+            reheats = 0;
+            continue;
+        }
+        if (++stagnant < SA_STAGNATION_EPOCHS)
+            continue;
+
+        stagnant = 0;
+        if (hybrid && chain->current.energy <= size) {
+            // Plateau z niską energią: większość planszy jest dobra, resztę dokończy solver dokładny
+            if (sa_exact_finish(chain, board, chain->current.grid, SA_FINISH_NODES))
+                break;
+        }
+
+        // Stagnacja: podgrzanie w miejscu albo nowe losowe wypełnienie
+        if (++reheats > SA_MAX_REHEATS) {
+            chain_flush_best(chain);
+            initialize_state(&chain->current, board, &chain->rng);
+            if (chain->current.energy < chain->best_energy) {
+                chain->best_energy = chain->current.energy;
+                chain->best_pending = 1;
             }
+            reheats = 0;
         }
+        run_best = chain->current.energy;
+        T = T0 * SA_REHEAT_FRACTION;
+    }
+    chain_flush_best(chain);
+    return iteration;
+}
 
-        T *= alpha;
-        iteration++;
+/**
+ * Funkcja zaznacza w mask zmienne pola należące do konfliktów: pola, których cyfra
+ * powtarza się w wierszu lub kolumnie, albo wszystkie zmienne pola wierszy i kolumn
+ * zawierających powtórzenia.
+ * @param board - plansza z oznaczeniem pól stałych
+ * @param grid - pełna plansza (bloki są permutacjami, więc konflikty są tylko w wierszach i kolumnach)
+ * @param mask - wynik: 1 dla pól do wyczyszczenia
+ * @param duplicates_only - 1 - tylko powtórzone cyfry, 0 - całe wiersze i kolumny z powtórzeniami
+ * @return liczba zaznaczonych pól
+ */
+static int mark_conflicts(const Board *board, const uint8_t *grid, uint8_t *mask, int duplicates_only) {
+    int size = board->size;
+    uint8_t row_count[MAX_SIZE][MAX_SIZE + 1], col_count[MAX_SIZE][MAX_SIZE + 1];
+    uint8_t bad_row[MAX_SIZE] = {0}, bad_col[MAX_SIZE] = {0};
+    memset(row_count, 0, sizeof(row_count));
+    memset(col_count, 0, sizeof(col_count));
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int val = grid[r * size + c];
+            if (++row_count[r][val] > 1) bad_row[r] = 1;
+            if (++col_count[c][val] > 1) bad_col[c] = 1;
+        }
+    }
 
-        if (iteration % 100 == 0) {
-            printf("Iteracja: %d, T: %.4f, Energia: %d\n", iteration, T, best.energy);
+    int marked = 0;
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int idx = r * size + c, val = grid[idx];
+            int clear = duplicates_only ? row_count[r][val] > 1 || col_count[c][val] > 1 : bad_row[r] || bad_col[c];
+            mask[idx] = clear && !isFixedCell(board, idx);
+            marked += mask[idx];
         }
     }
+    return marked;
+}
 
-    // Przepisanie najlepszego rozwiązania
-    for (int i = 0; i < size; i++) {
-        memcpy(initial[i], best.grid[i], size * sizeof(int));
+/**
+ * Funkcja dokańcza planszę solverem dokładnym: pola w konflikcie są czyszczone,
+ * a reszta planszy grid zostaje jako wskazówki. Jeśli takie wskazówki są sprzeczne
+ * (albo limit zostanie przekroczony), czyszczone są całe wiersze i kolumny z powtórzeniami.
+ * Przy sukcesie rozwiązanie trafia do chain->best z energią 0.
+ * @param chain - łańcuch wyżarzania
+ * @param board - plansza z oznaczeniem pól stałych
+ * @param grid - pełna plansza z niską energią (np. stan łańcucha na plateau)
+ * @param node_limit - limit węzłów solvera dokładnego na każdą z dwóch prób
+ * @return 1 jeśli plansza została rozwiązana, 0 w przeciwnym wypadku
+ */
+int sa_exact_finish(SAChain *chain, const Board *board, const uint8_t *grid, long node_limit) {
+    int size = board->size;
+    int n = size * size;
+    if (node_limit <= 0)
+        return 0;
+    uint8_t mask[MAX_SIZE * MAX_SIZE];
+    Board *partial = allocateBoard(size);
+    int solved = 0;
+    chain->finish_attempts++;
+
+    for (int duplicates_only = 1; duplicates_only >= 0 && !solved; duplicates_only--) {
+        mark_conflicts(board, grid, mask, duplicates_only);
+        for (int idx = 0; idx < n; idx++)
+            partial->cells[idx] = mask[idx] ? 0 : grid[idx];
+        solved = solveExactBudget(partial, NULL, node_limit) == 1;
     }
+    if (solved) {
+        memcpy(chain->best, partial->cells, n);
+        chain->best_energy = 0;
+        chain->best_pending = 0;
+        chain->finished_exact = 1;
+    }
+    freeBoard(partial);
+    return solved;
+}
+
+/**
+ * Funkcja zwraca czas w sekundach od chwili start.
+ */
+double seconds_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Funkcja przygotowuje kopię planszy dla wyżarzania z polami wymuszonymi przez
+ * propagację ograniczeń (oznaczonymi jako stałe), aby SA losował ruchy tylko
+ * wśród pól naprawdę niepewnych. Zeruje statystyki i zapisuje w nich czas propagacji.
+ * @param board - początkowa plansza z polami stałymi
+ * @param stats - statystyki przebiegu
+ * @return kopia planszy do zwolnienia przez freeBoard
+ */
+static Board *presolve_copy(const Board *board, SAStats *stats) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    memset(stats, 0, sizeof(SAStats));
+
+    Board *work = allocateBoard(board->size);
+    copyBoard(board, work);
+    int forced = presolveBoard(work);
+    if (forced < 0)
+        copyBoard(board, work); // plansza sprzeczna - wyżarzanie minimalizuje konflikty oryginału
+    else
+        stats->presolved_cells = forced;
+    stats->presolve_seconds = seconds_since(&start);
+    return work;
+}
+
+/**
+ * Funkcja uzupełnia statystyki o wynik i wypisuje podsumowanie, jeśli monitor tego chce.
+ * @param stats - statystyki przebiegu
+ * @param best_energy - energia zwróconej planszy
+ * @param monitor - monitor przebiegu (NULL - brak)
+ */
+static void finish_stats(SAStats *stats, int best_energy, const SAMonitor *monitor) {
+    stats->best_energy = best_energy;
+    stats->solved = best_energy == 0;
+    if (monitor && monitor->verbose)
+        printf("Propagacja ograniczeń: wypełniono %d pól\nFinalna energia: %d (iteracje: %ld)\n",
+               stats->presolved_cells, best_energy, stats->iterations);
+}
+
+/**
+ * Główna funkcja wykonująca optymalizację symulowanym wyżarzaniem.
+ * Szuka stanu planszy o minimalnej energii. Pola wymuszone przez ograniczenia
+ * wypełniane są wcześniej (presolve.c) - łatwe plansze nie wymagają wyżarzania.
+ * @param board - początkowa plansza z polami stałymi, nadpisywana najlepszym rozwiązaniem
+ * @param T_start - temperatura początkowa
+ * @param T_end - temperatura końcowa
+ * @param alpha - współczynnik chłodzenia
+ * @param max_iterations - maksymalna liczba iteracji
+ * @param seed - ziarno generatora liczb losowych (to samo ziarno daje ten sam przebieg)
+ * @param monitor - próbkowanie przebiegu (NULL - brak)
+ * @return statystyki przebiegu
+ */
+SAStats solve_sudoku_sa(Board *board, double T_start, double T_end, double alpha, int max_iterations, uint64_t seed,
+                        const SAMonitor *monitor) {
+    int size = board->size;
+    SAStats stats;
+    SAChain chain;
+    Board *work = presolve_copy(board, &stats);
+    if (isValidSolution(work)) {
+        // Propagacja rozwiązała całą planszę - wyżarzanie jest zbędne
+        memcpy(board->cells, work->cells, size * size);
+        finish_stats(&stats, 0, monitor);
+        freeBoard(work);
+        return stats;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    chain_init(&chain, work, seed, 0);
+    stats.init_seconds = seconds_since(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sa_run(&chain, T_start, T_end, alpha, max_iterations, monitor);
+    stats.anneal_seconds = seconds_since(&start);
+
+    // Przepisanie najlepszego rozwiązania
+    memcpy(board->cells, chain.best, size * size);
+    chain_add_stats(&chain, &stats);
+    finish_stats(&stats, chain.best_energy, monitor);
 
-    printf("\nFinalna energia: %d\n", best.energy);
     // Zwolnienie pamięci
-    free_state(&current);
-    free_state(&neighbor);
-    free_state(&best);
+    chain_free(&chain);
+    freeBoard(work);
+    return stats;
+}
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int count; // liczba wątków, które dotarły do bariery
+    int generation; // numer bieżącej fazy bariery
+    int total; // liczba wątków
+} SABarrier;
+
+/**
+ * Funkcja czeka aż wszystkie wątki dotrą do bariery
+ * (własna implementacja - pthread_barrier_t nie jest dostępny na macOS).
+ * @param barrier - bariera
+ */
+static void barrier_wait(SABarrier *barrier) {
+    pthread_mutex_lock(&barrier->mutex);
+    int generation = barrier->generation;
+    if (++barrier->count == barrier->total) {
+        barrier->count = 0;
+        barrier->generation++;
+        pthread_cond_broadcast(&barrier->cond);
+    } else {
+        while (generation == barrier->generation)
+            pthread_cond_wait(&barrier->cond, &barrier->mutex);
+    }
+    pthread_mutex_unlock(&barrier->mutex);
 }
 
+typedef struct {
+    SAChain *chains; // łańcuchy, po jednym na wątek
+    double *scale; // mnożnik temperatury każdego łańcucha (drabina temperatur)
+    int num_chains; // liczba łańcuchów
+    int replica_exchange; // 1 - wymiana replik między sąsiednimi temperaturami
+    double T_start, T_end, alpha; // parametry chłodzenia
+    int max_iterations; // maksymalna liczba iteracji każdego łańcucha
+    const SAMonitor *monitor; // próbkowanie przebiegu łańcucha 0 (NULL - brak)
+    atomic_int stop; // ustawiane, gdy któryś łańcuch osiągnie energię 0
+    int halt; // stan flagi stop odczytany przez wątek 0 między barierami (wspólna decyzja o końcu)
+    SABarrier barrier; // synchronizacja na końcu każdej epoki
+    Rng exchange_rng; // generator dla decyzji o wymianie (tylko wątek 0)
+    int epoch; // numer epoki - naprzemiennie pary parzyste i nieparzyste
+} SAParallel;
+
+typedef struct {
+    SAParallel *shared; // wspólne dane wszystkich wątków
+    int id; // numer łańcucha
+} SAWorker;
+
+/**
+ * Funkcja próbuje zamienić temperatury sąsiednich łańcuchów (parallel tempering).
+ * Zamieniane są mnożniki temperatur, a nie plansze, więc wymiana jest O(1).
+ * @param p - wspólne dane wątków
+ * @param T - aktualna temperatura bazowa
+ */
+static void exchange_replicas(SAParallel *p, double T) {
+    int n = p->num_chains;
+    int level[n]; // level[k] - łańcuch na k-tym szczeblu drabiny
+    // Posortuj łańcuchy według mnożnika temperatury (n jest małe)
+    for (int i = 0; i < n; i++) level[i] = i;
+    for (int i = 1; i < n; i++) {
+        int x = level[i], j = i - 1;
+        while (j >= 0 && p->scale[level[j]] > p->scale[x]) {
+            level[j + 1] = level[j];
+            j--;
+        }
+        level[j + 1] = x;
+    }
+
+    for (int k = p->epoch % 2; k + 1 < n; k += 2) {
+        int a = level[k], b = level[k + 1];
+        double Ta = T * p->scale[a], Tb = T * p->scale[b];
+        double arg = (p->chains[a].current.energy - p->chains[b].current.energy) * (1.0 / Ta - 1.0 / Tb);
+        if (arg >= 0 || exp(arg) > rngDouble(&p->exchange_rng)) {
+            double tmp = p->scale[a];
+            p->scale[a] = p->scale[b];
+            p->scale[b] = tmp;
+        }
+    }
+    p->epoch++;
+}
+
+/**
+ * Funkcja wątku: prowadzi jeden łańcuch w epokach po SA_EXCHANGE_INTERVAL iteracji.
+ * @param arg - wskaźnik na SAWorker
+ */
+static void *sa_worker(void *arg) {
+    SAWorker *worker = arg;
+    SAParallel *p = worker->shared;
+    SAChain *chain = &p->chains[worker->id];
+    SAKernel kernel = select_kernel(chain->current.size);
+    const SAMonitor *monitor = worker->id == 0 ? p->monitor : NULL;
+    double T = p->T_start;
+    int iteration = 0;
+    int done = 0;
+
+    while (1) {
+        int steps = p->max_iterations - iteration;
+        if (steps > SA_EXCHANGE_INTERVAL)
+            steps = SA_EXCHANGE_INTERVAL;
+        iteration += run_sampled(kernel, chain, &T, p->scale[worker->id], p->alpha, p->T_end, steps, &p->stop,
+                                 monitor);
+        if (chain->best_energy == 0)
+            atomic_store(&p->stop, 1); // rozwiązanie - przerwij pozostałe wątki
+        if (T <= p->T_end || iteration >= p->max_iterations)
+            done = 1;
+
+        barrier_wait(&p->barrier);
+        if (worker->id == 0) {
+            // Migawka flagi między barierami - stop ustawiony już w następnej epoce
+            // nie może sprawić, że część wątków skończy, a reszta czeka na barierze
+            p->halt = atomic_load(&p->stop);
+            if (p->replica_exchange && !p->halt)
+                exchange_replicas(p, T);
+        }
+        barrier_wait(&p->barrier);
+        // Wszystkie łańcuchy wykonały tyle samo iteracji, więc decyzja o końcu jest wspólna
+        if (done || p->halt)
+            break;
+    }
+    chain_flush_best(chain);
+    return NULL;
+}
+
+/**
+ * Równoległe wyżarzanie: num_threads łańcuchów, każdy na własnym wątku i z własnym
+ * generatorem liczb losowych. Łańcuchy są niezależne albo tworzą drabinę temperatur
+ * z okresową wymianą replik. Wszystkie wątki kończą pracę, gdy któryś znajdzie energię 0.
+ * Tak jak w wersji jednowątkowej, wyżarzanie startuje z planszy po propagacji ograniczeń.
+ * @param board - początkowa plansza z polami stałymi, nadpisywana najlepszym rozwiązaniem
+ * @param T_start - temperatura początkowa
+ * @param T_end - temperatura końcowa
+ * @param alpha - współczynnik chłodzenia
+ * @param max_iterations - maksymalna liczba iteracji każdego łańcucha
+ * @param num_threads - liczba wątków (łańcuchów)
+ * @param replica_exchange - 1 dla drabiny temperatur z wymianą replik, 0 dla niezależnych startów
+ * @param seed - ziarno bazowe; łańcuch i używa strumienia i + 1
+ * @param monitor - próbkowanie przebiegu łańcucha 0 (NULL - brak)
+ * @return statystyki przebiegu (liczniki zsumowane po łańcuchach)
+ */
+SAStats solve_sudoku_sa_parallel(Board *board, double T_start, double T_end, double alpha, int max_iterations,
+                                 int num_threads, int replica_exchange, uint64_t seed, const SAMonitor *monitor) {
+    int size = board->size;
+    if (num_threads < 1) num_threads = 1;
+    SAStats stats;
+    Board *work = presolve_copy(board, &stats);
+    if (isValidSolution(work)) {
+        memcpy(board->cells, work->cells, size * size);
+        finish_stats(&stats, 0, monitor);
+        freeBoard(work);
+        return stats;
+    }
+
+    SAParallel p;
+    p.chains = malloc(num_threads * sizeof(SAChain));
+    p.scale = malloc(num_threads * sizeof(double));
+    p.num_chains = num_threads;
+    p.replica_exchange = replica_exchange && num_threads > 1;
+    p.T_start = T_start;
+    p.T_end = T_end;
+    p.alpha = alpha;
+    p.max_iterations = max_iterations;
+    p.monitor = monitor;
+    atomic_init(&p.stop, 0);
+    p.halt = 0;
+    pthread_mutex_init(&p.barrier.mutex, NULL);
+    pthread_cond_init(&p.barrier.cond, NULL);
+    p.barrier.count = 0;
+    p.barrier.generation = 0;
+    p.barrier.total = num_threads;
+    p.epoch = 0;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    rngSeedStream(&p.exchange_rng, seed, 0);
+    for (int i = 0; i < num_threads; i++) {
+        chain_init(&p.chains[i], work, seed, (uint64_t)i + 1);
+        // Drabina geometryczna od 1 do SA_LADDER_MAX
+        p.scale[i] = p.replica_exchange ? pow(SA_LADDER_MAX, (double)i / (num_threads - 1)) : 1.0;
+    }
+    stats.init_seconds = seconds_since(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t threads[num_threads];
+    SAWorker workers[num_threads];
+    for (int i = 0; i < num_threads; i++) {
+        workers[i].shared = &p;
+        workers[i].id = i;
+        pthread_create(&threads[i], NULL, sa_worker, &workers[i]);
+    }
+    for (int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+    stats.anneal_seconds = seconds_since(&start);
+
+    // Wybór najlepszego łańcucha
+    int best = 0;
+    for (int i = 1; i < num_threads; i++)
+        if (p.chains[i].best_energy < p.chains[best].best_energy)
+            best = i;
+    memcpy(board->cells, p.chains[best].best, size * size);
+    for (int i = 0; i < num_threads; i++)
+        chain_add_stats(&p.chains[i], &stats);
+    finish_stats(&stats, p.chains[best].best_energy, monitor);
+
+    for (int i = 0; i < num_threads; i++)
+        chain_free(&p.chains[i]);
+    free(p.chains);
+    free(p.scale);
+    pthread_mutex_destroy(&p.barrier.mutex);
+    pthread_cond_destroy(&p.barrier.cond);
+    freeBoard(work);
+    return stats;
+}
+
+typedef struct {
+    SAChain chain; // łańcuch prowadzony przez wątek
+    const Board *board; // plansza z polami stałymi (tylko do odczytu)
+    int max_iterations; // maksymalna liczba iteracji łańcucha
+    atomic_int *stop; // wspólna flaga przerwania
+    const struct timespec *deadline; // termin wyżarzania (NULL - brak)
+    const SAMonitor *monitor; // próbkowanie przebiegu (tylko łańcuch 0)
+    int hybrid; // 1 - plateau dokańczane solverem dokładnym
+} SAAdaptiveWorker;
+
+/**
+ * Funkcja wątku: prowadzi jeden łańcuch adaptacyjnym schematem chłodzenia.
+ * @param arg - wskaźnik na SAAdaptiveWorker
+ */
+static void *sa_adaptive_worker(void *arg) {
+    SAAdaptiveWorker *worker = arg;
+    sa_run_adaptive(&worker->chain, worker->board, worker->max_iterations, worker->stop, worker->deadline,
+                    worker->monitor, worker->hybrid);
+    if (worker->chain.best_energy == 0)
+        atomic_store(worker->stop, 1); // rozwiązanie - przerwij pozostałe wątki
+    return NULL;
+}
+
+/**
+ * Wspólna część wyżarzania adaptacyjnego i hybrydowego: niezależne łańcuchy
+ * sa_run_adaptive na osobnych wątkach, przerywane, gdy któryś znajdzie energię 0.
+ * W trybie hybrydowym całość ma limit time_limit: łańcuchy kończą najpóźniej
+ * w terminie, a plansza przez nie nierozwiązana jest rozwiązywana solverem dokładnym
+ * w pozostałym czasie. Gdy czas się skończy, zwracana jest najlepsza plansza łańcuchów
+ * (stats.solved = 0).
+ * @param time_limit - limit czasu trybu hybrydowego w sekundach (0 - bez limitu)
+ * @param hybrid - 1 dla trybu hybrydowego
+ * Pozostałe parametry jak w solve_sudoku_sa_adaptive.
+ */
+static SAStats solve_adaptive(Board *board, int max_iterations, int num_threads, uint64_t seed,
+                              const SAMonitor *monitor, double time_limit, int hybrid) {
+    int size = board->size;
+    if (num_threads < 1) num_threads = 1;
+    int timed = hybrid && time_limit > 0;
+    struct timespec deadline;
+    deadline_after(&deadline, time_limit);
+    SAStats stats;
+    Board *work = presolve_copy(board, &stats);
+    if (isValidSolution(work)) {
+        memcpy(board->cells, work->cells, size * size);
+        finish_stats(&stats, 0, monitor);
+        freeBoard(work);
+        return stats;
+    }
+
+    atomic_int stop;
+    atomic_init(&stop, 0);
+    SAAdaptiveWorker *workers = malloc(num_threads * sizeof(SAAdaptiveWorker));
+    pthread_t threads[num_threads];
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < num_threads; i++) {
+        chain_init(&workers[i].chain, work, seed, (uint64_t)i + 1);
+        workers[i].board = work;
+        workers[i].max_iterations = max_iterations;
+        workers[i].stop = &stop;
+        workers[i].deadline = timed ? &deadline : NULL;
+        workers[i].monitor = i == 0 ? monitor : NULL;
+        workers[i].hybrid = hybrid;
+    }
+    stats.init_seconds = seconds_since(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < num_threads; i++)
+        pthread_create(&threads[i], NULL, sa_adaptive_worker, &workers[i]);
+    for (int i = 0; i < num_threads; i++)
+        pthread_join(threads[i], NULL);
+    stats.anneal_seconds = seconds_since(&start);
+
+    int best = 0;
+    for (int i = 1; i < num_threads; i++)
+        if (workers[i].chain.best_energy < workers[best].chain.best_energy)
+            best = i;
+    SAChain *chain = &workers[best].chain;
+    double remaining = timed ? -seconds_since(&deadline) : 0;
+    if (hybrid && chain->best_energy > 0 && (!timed || remaining > 0) &&
+        solveExactLimited(work, NULL, 0, remaining) == 1) {
+        // Budżet iteracji wyczerpany bez rozwiązania - resztę czasu dostaje pełne przeszukiwanie
+        memcpy(chain->best, work->cells, size * size);
+        chain->best_energy = 0;
+        chain->finished_exact = 1;
+    }
+    memcpy(board->cells, chain->best, size * size);
+    for (int i = 0; i < num_threads; i++)
+        chain_add_stats(&workers[i].chain, &stats);
+    stats.finished_exact = chain->finished_exact;
+    finish_stats(&stats, chain->best_energy, monitor);
+
+    for (int i = 0; i < num_threads; i++)
+        chain_free(&workers[i].chain);
+    free(workers);
+    freeBoard(work);
+    return stats;
+}
+
+/**
+ * Wyżarzanie z adaptacyjnym schematem chłodzenia (sa_run_adaptive): temperatura
+ * początkowa kalibrowana z próbnych ruchów, chłodzenie po epokach i podgrzewanie
+ * przy stagnacji. Przy kilku wątkach łańcuchy są niezależne (każdy sam się podgrzewa),
+ * a wszystkie kończą pracę, gdy któryś znajdzie energię 0.
+ * @param board - początkowa plansza z polami stałymi, nadpisywana najlepszym rozwiązaniem
+ * @param max_iterations - maksymalna liczba iteracji każdego łańcucha
+ * @param num_threads - liczba wątków (łańcuchów)
+ * @param seed - ziarno bazowe; łańcuch i używa strumienia i + 1
+ * @param monitor - próbkowanie przebiegu łańcucha 0 (NULL - brak)
+ * @return statystyki przebiegu (liczniki zsumowane po łańcuchach)
+ */
+SAStats solve_sudoku_sa_adaptive(Board *board, int max_iterations, int num_threads, uint64_t seed,
+                                 const SAMonitor *monitor) {
+    return solve_adaptive(board, max_iterations, num_threads, seed, monitor, 0, 0);
+}
+
+/**
+ * Wyżarzanie hybrydowe: jak solve_sudoku_sa_adaptive, ale plateau z niską energią
+ * dokańczane jest solverem dokładnym po wyczyszczeniu pól w konflikcie, a po
+ * wyczerpaniu budżetu iteracji plansza jest rozwiązywana dokładnie w czasie
+ * pozostałym z time_limit.
+ * @param board - początkowa plansza z polami stałymi, nadpisywana rozwiązaniem
+ *                (lub najlepszą planszą, gdy skończył się czas)
+ * @param max_iterations - maksymalna liczba iteracji wyżarzania każdego łańcucha
+ * @param num_threads - liczba wątków (łańcuchów)
+ * @param seed - ziarno bazowe; łańcuch i używa strumienia i + 1
+ * @param monitor - próbkowanie przebiegu łańcucha 0 (NULL - brak)
+ * @param time_limit - łączny limit czasu w sekundach (0 - bez limitu)
+ * @return statystyki przebiegu
+ */
+SAStats solve_sudoku_sa_hybrid(Board *board, int max_iterations, int num_threads, uint64_t seed,
+                               const SAMonitor *monitor, double time_limit) {
+    return solve_adaptive(board, max_iterations, num_threads, seed, monitor, time_limit, 1);
+}
+
+/**
+ * Wyżarzanie adaptacyjne w czasie wyznaczonym przez wywołującego: łańcuch pracuje do rozwiązania,
+ * terminu albo ustawienia flagi cancel i zawsze zwraca najlepszą dotąd planszę. Flaga sprawdzana
+ * jest w każdej iteracji (odczyt atomowy bez bariery), a zegar co SA_DEADLINE_CHECK_STEPS iteracji.
+ * Bez terminu i bez flagi obowiązuje limit SA_UNTIL_MAX_ITERATIONS iteracji (wynik SA_STATUS_FAIL).
+ * @param board - początkowa plansza z polami stałymi, nadpisywana najlepszą znalezioną planszą
+ * @param deadline - termin CLOCK_MONOTONIC (NULL - brak; kończy wtedy rozwiązanie, cancel
+ *                   lub, gdy cancel też jest NULL, limit iteracji)
+ * @param cancel - flaga przerwania ustawiana z innego wątku (NULL - brak)
+ * @param seed - ziarno generatora liczb losowych
+ * @param monitor - próbkowanie przebiegu (NULL - brak)
+ * @return status, czas od wywołania i statystyki przebiegu
+ */
+SAAnytimeResult solve_sudoku_sa_until(Board *board, const struct timespec *deadline, atomic_int *cancel,
+                                      uint64_t seed, const SAMonitor *monitor) {
+    struct timespec called;
+    clock_gettime(CLOCK_MONOTONIC, &called);
+    int size = board->size;
+    SAAnytimeResult result;
+    SAChain chain;
+    Board *work = presolve_copy(board, &result.stats);
+    if (isValidSolution(work)) {
+        memcpy(board->cells, work->cells, size * size);
+        finish_stats(&result.stats, 0, monitor);
+        freeBoard(work);
+        result.status = SA_STATUS_SOLVED;
+        result.elapsed_seconds = seconds_since(&called);
+        return result;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    chain_init(&chain, work, seed, 0);
+    result.stats.init_seconds = seconds_since(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int cancelled = 0;
+    // Bez terminu i bez flagi nic nie zatrzymałoby nierozwiązywalnej planszy - obowiązuje wtedy limit iteracji
+    int capped = deadline == NULL && cancel == NULL;
+    long remaining = SA_UNTIL_MAX_ITERATIONS;
+    while (chain.best_energy > 0) {
+        cancelled = cancel != NULL && atomic_load_explicit(cancel, memory_order_relaxed);
+        if (cancelled || deadline_passed(deadline) || (capped && remaining <= 0))
+            break;
+        // Po wyczerpaniu limitu iteracji (int) łańcuch jest kalibrowany ponownie i pracuje dalej
+        int steps = capped && remaining < INT_MAX ? (int)remaining : INT_MAX;
+        int done = sa_run_adaptive(&chain, work, steps, cancel, deadline, monitor, 0);
+        remaining -= done > 0 ? done : 1;
+    }
+    result.stats.anneal_seconds = seconds_since(&start);
+
+    memcpy(board->cells, chain.best, size * size);
+    chain_add_stats(&chain, &result.stats);
+    finish_stats(&result.stats, chain.best_energy, monitor);
+    chain_free(&chain);
+    freeBoard(work);
+    if (chain.best_energy == 0)
+        result.status = SA_STATUS_SOLVED;
+    else if (cancelled)
+        result.status = SA_STATUS_CANCELLED;
+    else
+        result.status = capped ? SA_STATUS_FAIL : SA_STATUS_TIMEOUT;
+    result.elapsed_seconds = seconds_since(&called);
+    return result;
+}
@@ -5,19 +5,213 @@
 
  #ifndef SA_ALGORITHM_H
  #define SA_ALGORITHM_H
+
+ #include <stdint.h>
+ #include <stdatomic.h>
+ #include <time.h>
+ #include "board.h"
+
+ #define SA_RING_CAPACITY 1024 // pojemność bufora próbek (potęga dwójki)
+ #define SA_BATCH_LANES 16 // liczba zagadek prowadzonych razem przez solve_sudoku_sa_batch (tory partii)
+
+ #define SA_STATUS_SOLVED 0 // znaleziono rozwiązanie (energia 0)
+ #define SA_STATUS_TIMEOUT 1 // minął termin - plansza zawiera najlepszy dotąd stan
+ #define SA_STATUS_CANCELLED 2 // ustawiono flagę przerwania - plansza zawiera najlepszy dotąd stan
+ #define SA_STATUS_FAIL 3 // wyczerpano limit iteracji (wywołanie bez terminu i flagi) - plansza zawiera najlepszy dotąd stan
+
+ /**
+  * Próbka przebiegu wyżarzania zbierana co SAMonitor.interval iteracji łańcucha.
+  */
+ typedef struct {
+     long iteration; // numer iteracji łańcucha
+     double temperature; // aktualna temperatura łańcucha
+     int energy; // energia aktualnego stanu
+     int best_energy; // najniższa dotąd energia łańcucha
+ } SASample;
+
+ /**
+  * Bufor cykliczny próbek bez blokad dla jednego producenta (wątek wyżarzania)
+  * i jednego konsumenta (np. wątek monitorujący). Gdy bufor jest pełny, nowe próbki
+  * są odrzucane i zliczane w dropped - wyżarzanie nigdy nie czeka na konsumenta.
+  */
+ typedef struct {
+     SASample items[SA_RING_CAPACITY]; // próbki
+     atomic_ulong head; // liczba zapisanych próbek (zmienia tylko producent)
+     atomic_ulong tail; // liczba odczytanych próbek (zmienia tylko konsument)
+     atomic_ulong dropped; // liczba próbek odrzuconych z powodu pełnego bufora
+ } SASampleRing;
+
+ /**
+  * Funkcja wywoływana dla każdej próbki (w wątku łańcucha, więc musi być krótka).
+  */
+ typedef void (*SAProgressCallback)(const SASample *sample, void *user);
+
+ /**
+  * Opcjonalne monitorowanie przebiegu. Próbki pobierane są tylko z łańcucha 0,
+  * więc bufor ma zawsze jednego producenta. Brak monitora (NULL) oznacza pracę
+  * bez żadnego wyjścia i bez kosztu w pętli wyżarzania.
+  */
+ typedef struct {
+     int interval; // co ile iteracji pobierana jest próbka (0 - bez próbek)
+     SAProgressCallback callback; // wywoływana dla każdej próbki (NULL - brak)
+     void *user; // argument przekazywany do callback
+     SASampleRing *ring; // bufor, do którego trafiają próbki (NULL - brak)
+     int verbose; // 1 - próbki i podsumowanie wypisywane na konsolę
+ } SAMonitor;
+
+ /**
+  * Statystyki przebiegu zwracane przez funkcje rozwiązujące. Przy kilku łańcuchach
+  * liczniki ruchów są sumą po łańcuchach.
+  */
+ typedef struct {
+     long iterations; // wykonane iteracje
+     long accepted; // zaakceptowane ruchy
+     long rejected; // odrzucone ruchy
+     long uphill; // zaakceptowane ruchy zwiększające energię
+     int best_energy; // energia zwróconej planszy
+     int solved; // 1 jeśli znaleziono rozwiązanie (energia 0)
+     int presolved_cells; // pola wypełnione przez propagację ograniczeń
+     int finish_attempts; // próby dokończenia planszy solverem dokładnym (tryb hybrydowy)
+     int finished_exact; // 1 jeśli zwróconą planszę dokończył solver dokładny
+     double presolve_seconds; // czas propagacji ograniczeń
+     double init_seconds; // czas przygotowania łańcuchów (losowe wypełnienie)
+     double anneal_seconds; // czas wyżarzania
+ } SAStats;
+
+ /**
+  * Wynik solve_sudoku_sa_until.
+  */
+ typedef struct {
+     int status; // SA_STATUS_SOLVED, SA_STATUS_TIMEOUT, SA_STATUS_CANCELLED lub SA_STATUS_FAIL
+     double elapsed_seconds; // czas od wywołania do zwrócenia planszy (z propagacją i przygotowaniem łańcucha)
+     SAStats stats; // statystyki przebiegu
+ } SAAnytimeResult;
+
+ /**
+  * Pobiera najstarszą próbkę z bufora (po stronie konsumenta).
+  * @param ring - bufor próbek
+  * @param sample - miejsce na próbkę
+  * @return 1 jeśli pobrano próbkę, 0 jeśli bufor jest pusty
+  */
+ int sa_ring_pop(SASampleRing *ring, SASample *sample);
  
  /**
-  * Rozwiązuje Sudoku przy użyciu algorytmu wyżarzania
+  * Rozwiązuje Sudoku przy użyciu algorytmu wyżarzania.
+  * Najpierw wypełniane są pola wymuszone przez ograniczenia (nagie i ukryte single,
+  * zablokowani kandydaci); jeśli to rozwiązuje planszę, wyżarzanie nie jest uruchamiane.
   * 
-  * @param initial - wskaźnik na dwuwymiarową tablicę z początkową planszą Sudoku (z lukami)
-  * @param fixed - wskaźnik na dwuwymiarową tablicę oznaczającą, które pola są stałe 
-  * @param size - rozmiar planszy Sudoku
+  * @param board - początkowa plansza Sudoku (z lukami i oznaczonymi polami stałymi);
+  *                po zakończeniu zawiera najlepsze znalezione rozwiązanie
   * @param T_start - temperatura początkowa
   * @param T_end - temperatura końcowa (końcowy warunek zatrzymania)
   * @param alpha - współczynnik zmniejszania temperatury
   * @param max_iterations - maksymalna liczba iteracji algorytmu
+  * @param seed - ziarno generatora liczb losowych (to samo ziarno daje ten sam przebieg)
+  * @param monitor - próbkowanie przebiegu (NULL - brak, bez wypisywania na konsolę)
+  * @return statystyki przebiegu
+  */
+ SAStats solve_sudoku_sa(Board *board, double T_start, double T_end, double alpha, int max_iterations, uint64_t seed,
+                         const SAMonitor *monitor);
+ 
+ /**
+  * Rozwiązuje Sudoku równoległym wyżarzaniem na wielu wątkach (pthreads).
+  * Każdy wątek prowadzi własny łańcuch z własnym generatorem liczb losowych;
+  * łańcuchy są niezależne lub tworzą drabinę temperatur z wymianą replik.
+  * Wszystkie wątki są przerywane, gdy któryś łańcuch osiągnie energię 0.
+  *
+  * @param board - początkowa plansza Sudoku (z lukami i oznaczonymi polami stałymi);
+  *                po zakończeniu zawiera najlepsze znalezione rozwiązanie
+  * @param T_start - temperatura początkowa (najzimniejszego łańcucha)
+  * @param T_end - temperatura końcowa (końcowy warunek zatrzymania)
+  * @param alpha - współczynnik zmniejszania temperatury
+  * @param max_iterations - maksymalna liczba iteracji każdego łańcucha
+  * @param num_threads - liczba wątków (łańcuchów)
+  * @param replica_exchange - 1: drabina temperatur z wymianą replik, 0: niezależne starty
+  * @param seed - ziarno bazowe; każdy łańcuch dostaje własny strumień generatora
+  * @param monitor - próbkowanie przebiegu łańcucha 0 (NULL - brak)
+  * @return statystyki przebiegu
+  */
+ SAStats solve_sudoku_sa_parallel(Board *board, double T_start, double T_end, double alpha, int max_iterations,
+                                  int num_threads, int replica_exchange, uint64_t seed, const SAMonitor *monitor);
+
+ /**
+  * Rozwiązuje Sudoku wyżarzaniem z adaptacyjnym schematem chłodzenia: temperatura
+  * początkowa wyznaczana jest z odchylenia standardowego zmian energii próbnych ruchów,
+  * temperatura maleje po każdej epoce (a nie po każdym ruchu), a przy stagnacji łańcuch
+  * jest podgrzewany lub startuje od nowa. Nie wymaga strojenia T_start/alpha.
+  *
+  * @param board - początkowa plansza Sudoku (z lukami i oznaczonymi polami stałymi);
+  *                po zakończeniu zawiera najlepsze znalezione rozwiązanie
+  * @param max_iterations - maksymalna liczba iteracji każdego łańcucha
+  * @param num_threads - liczba wątków (niezależnych łańcuchów)
+  * @param seed - ziarno bazowe; każdy łańcuch dostaje własny strumień generatora
+  * @param monitor - próbkowanie przebiegu łańcucha 0 (NULL - brak)
+  * @return statystyki przebiegu
+  */
+ SAStats solve_sudoku_sa_adaptive(Board *board, int max_iterations, int num_threads, uint64_t seed,
+                                  const SAMonitor *monitor);
+
+ /**
+  * Rozwiązuje Sudoku hybrydowo: wyżarzanie adaptacyjne szybko zbliża się do rozwiązania,
+  * a gdy utknie na plateau z niską energią, pola w konflikcie (powtórzone cyfry w wierszach
+  * i kolumnach) są czyszczone i resztę planszy dokańcza solver bitowy z własnym limitem węzłów
+  * na próbę. Jeśli budżet iteracji się wyczerpie, plansza jest rozwiązywana
+  * dokładnie. Całość (wyżarzanie i solver dokładny) ma limit czasu time_limit; po nim
+  * zwracana jest najlepsza plansza wyżarzania, a stats.solved wynosi 0.
+  *
+  * @param board - początkowa plansza Sudoku (z lukami i oznaczonymi polami stałymi);
+  *                po zakończeniu zawiera rozwiązanie lub najlepszą znalezioną planszę
+  * @param max_iterations - maksymalna liczba iteracji każdego łańcucha
+  * @param num_threads - liczba wątków (niezależnych łańcuchów)
+  * @param seed - ziarno bazowe; każdy łańcuch dostaje własny strumień generatora
+  * @param monitor - próbkowanie przebiegu łańcucha 0 (NULL - brak)
+  * @param time_limit - łączny limit czasu w sekundach (0 - bez limitu)
+  * @return statystyki przebiegu
+  */
+ SAStats solve_sudoku_sa_hybrid(Board *board, int max_iterations, int num_threads, uint64_t seed,
+                                const SAMonitor *monitor, double time_limit);
+
+ /**
+  * Rozwiązuje wiele zagadek tego samego rozmiaru wyżarzaniem adaptacyjnym prowadzonym partiami:
+  * SA_BATCH_LANES łańcuchów (torów) wykonuje kroki jednocześnie na stanie w układzie struktury
+  * tablic - wartości pola (r, c) wszystkich torów leżą obok siebie, więc losowanie, zmiana energii
+  * i akceptacja Metropolisa (z przybliżeniem exp) liczone są wektorowo dla całej partii.
+  * Tor, który rozwiązał zagadkę lub wyczerpał limit iteracji, dostaje następną zagadkę z kolejki.
+  * Przed wyżarzaniem każda zagadka przechodzi propagację ograniczeń. Przebieg zagadki zależy
+  * tylko od seed i jej strumienia, a nie od pozostałych zagadek w partii.
+  *
+  * @param boards - plansze (z lukami i oznaczonymi polami stałymi) jednego rozmiaru;
+  *                 po zakończeniu każda zawiera najlepsze znalezione rozwiązanie
+  * @param count - liczba plansz
+  * @param max_iterations - maksymalna liczba iteracji na jedną zagadkę
+  * @param seed - ziarno bazowe
+  * @param streams - numer strumienia generatora dla każdej zagadki (NULL - numer zagadki w tablicy)
+  * @param solved - miejsce na wynik każdej zagadki: 1 rozwiązana, 0 nie (może być NULL)
+  * @return statystyki sumaryczne; solved to liczba rozwiązanych zagadek, a best_energy
+  *         największa energia zwróconej planszy; dla rozmiaru innego niż 4, 9, 16, 25 i 36
+  *         statystyki są zerowe, a plansze i solved pozostają bez zmian
+  */
+ SAStats solve_sudoku_sa_batch(Board **boards, int count, int max_iterations, uint64_t seed,
+                               const uint64_t *streams, int *solved);
+
+ /**
+  * Rozwiązuje Sudoku wyżarzaniem adaptacyjnym ograniczonym czasem zamiast liczbą iteracji
+  * (rozwiązanie "w każdej chwili"): łańcuch pracuje, dopóki nie znajdzie rozwiązania, nie minie
+  * termin albo inny wątek nie ustawi flagi cancel, i zawsze zwraca najlepszą dotąd planszę.
+  * Flaga odczytywana jest w każdej iteracji (odczyt atomowy bez bariery), a zegar co 1024
+  * iteracje, więc termin przekraczany jest najwyżej o ułamek milisekundy. Wywołanie bez terminu
+  * i bez flagi ma limit 50 mln iteracji i po jego wyczerpaniu zwraca SA_STATUS_FAIL.
+  *
+  * @param board - początkowa plansza Sudoku (z lukami i oznaczonymi polami stałymi);
+  *                po zakończeniu zawiera rozwiązanie lub najlepszą znalezioną planszę
+  * @param deadline - termin według zegara CLOCK_MONOTONIC (NULL - bez terminu)
+  * @param cancel - flaga przerwania; wartość różna od 0 kończy wyżarzanie (NULL - brak)
+  * @param seed - ziarno generatora liczb losowych
+  * @param monitor - próbkowanie przebiegu (NULL - brak)
+  * @return status (SA_STATUS_*), czas od wywołania i statystyki przebiegu
   */
- void solve_sudoku_sa(int **initial, int **fixed, int size, double T_start, double T_end, double alpha, int max_iterations);
+ SAAnytimeResult solve_sudoku_sa_until(Board *board, const struct timespec *deadline, atomic_int *cancel,
+                                       uint64_t seed, const SAMonitor *monitor);
  
  #endif
  
@@ -0,0 +1,636 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SA_algorithm.h"
+#include "SA_internal.h"
+#include "energy.h"
+#include "presolve.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SA_BATCH_HAVE_AVX2 1
+#endif
+
+#define LANES SA_BATCH_LANES
+#define SA_BATCH_VEC 4 // torów w jednym wektorze 16-bajtowym
+#define SA_BATCH_CHUNK 64 // maksymalna liczba wspólnych kroków torów między obsługą harmonogramu
+#define SA_BATCH_MIN_TEMPERATURE 1e-6 // dolna granica temperatury toru (odwrotność musi być skończona)
+#define SA_BATCH_EXP_FLOOR -80.0f // poniżej tego wykładnika prawdopodobieństwo akceptacji jest pomijalne
+#define SA_BATCH_GATHER_PAD 4 // zapas za tablicami bajtów torów (gather czyta po 4 bajty)
+
+// Wektory 16-bajtowe (rozszerzenie GCC/Clang) mają natywne rejestry na SSE2 i NEON; szersze typy
+// kompilator rozbija na operacje na pojedynczych torach. Fazy wektorowe idą po SA_BATCH_VEC torów.
+typedef int32_t vec_i32 __attribute__((vector_size(16)));
+typedef uint32_t vec_u32 __attribute__((vector_size(16)));
+typedef float vec_f32 __attribute__((vector_size(16)));
+#define LOAD_VEC(v, p) memcpy(&(v), (p), sizeof(v))
+#define STORE_VEC(p, v) memcpy((p), &(v), sizeof(v))
+
+typedef struct {
+    uint32_t cell[2][LANES]; // indeksy zamienianych pól w grid (idx * LANES + tor)
+    uint32_t row[2][LANES]; // początki liczników wierszy pól w row_count (r * (size + 1) * LANES + tor)
+    uint32_t col[2][LANES]; // początki liczników kolumn pól w col_count (c * (size + 1) * LANES + tor)
+    int32_t delta[LANES]; // zmiana energii po zamianie
+} SALaneMoves;
+
+typedef struct {
+    int puzzle; // numer zagadki w kolejce lub -1 dla pustego toru
+    int iterations; // iteracje bieżącej zagadki
+    int epoch_steps; // kroki wykonane w bieżącej epoce
+    int epoch_length; // długość epoki toru
+    double T0; // temperatura początkowa z kalibracji
+    double T; // temperatura bieżącej epoki
+    int stagnant; // epoki bez poprawy
+    int reheats; // nieudane podgrzania od ostatniej poprawy
+    int run_best; // najniższa energia na końcu epoki od ostatniego podgrzania
+    Rng rng; // generator toru do losowych wypełnień przy restarcie
+    Board *work; // zagadka toru po propagacji ograniczeń
+    uint8_t *best; // najlepsza plansza toru (wierszami)
+} SALane;
+
+typedef struct {
+    // Stan torów w układzie struktury tablic: wartość toru l w polu idx to grid[idx * LANES + l]
+    uint32_t rng[LANES]; // stan generatora xorshift32 toru
+    float inv_temperature[LANES]; // 1 / T toru
+    int32_t energy[LANES]; // energia aktualnego stanu
+    int32_t best_energy[LANES]; // energia najlepszego stanu
+    int32_t best_pending[LANES]; // -1 gdy aktualny stan jest niezapisanym minimum
+    int32_t live[LANES]; // -1 dla toru z zagadką, 0 dla pustego
+    int32_t accepted[LANES]; // zaakceptowane ruchy bieżącej zagadki
+    int32_t uphill[LANES]; // zaakceptowane ruchy pod górę bieżącej zagadki
+    uint32_t movable[LANES]; // liczba bloków z ruchami
+    uint8_t *grid; // plansze torów
+    uint8_t *row_count; // row_count[(r * (size + 1) + cyfra) * LANES + l]
+    uint8_t *col_count; // col_count[(c * (size + 1) + cyfra) * LANES + l]
+    uint32_t *free_cells; // zmienne pola toru l (idx | r << 16 | c << 24): free_cells[l * cells ..], blok po bloku
+    uint16_t *block_start; // początki bloków toru l: block_start[l * (size + 1) + k]
+    int size; // rozmiar planszy
+    int cells; // liczba pól
+    SALane lanes[LANES];
+    SAChain scratch; // łańcuch skalarny do losowego wypełnienia i kalibracji temperatury
+
+    Board **boards; // kolejka zagadek
+    int count; // liczba zagadek
+    int next; // następna zagadka do pobrania
+    uint64_t seed; // ziarno bazowe
+    const uint64_t *streams; // strumienie zagadek (NULL - numer zagadki)
+    int *solved; // wyniki zagadek (NULL - brak)
+    SAStats stats; // statystyki sumaryczne
+} SABatch;
+
+/**
+ * Funkcja zapisuje aktualny stan toru l jako najlepszy (kopiowanie kolumny struktury tablic).
+ */
+static void save_best(SABatch *b, int l) {
+    uint8_t *best = b->lanes[l].best;
+    for (int idx = 0; idx < b->cells; idx++)
+        best[idx] = b->grid[idx * LANES + l];
+}
+
+/**
+ * Funkcja losuje dla każdego toru zamianę dwóch zmiennych pól jednego bloku i liczy jej zmianę
+ * energii (jak generate_neighbor). Liczba z przedziału [0, n) to (16 bitów losu * n) >> 16 -
+ * dla n <= MAX_SIZE obciążenie rzędu n / 2^16 jest pomijalne, a iloczyn mieści się w 32 bitach.
+ * @param b - partia
+ * @param draw - liczby losowe torów: blok, pierwsze pole, drugie pole
+ * @param size - rozmiar planszy
+ * @param moves - wynik: pola zamiany i zmiana energii każdego toru
+ */
+static inline __attribute__((always_inline)) void propose_moves(const SABatch *b, uint32_t draw[][LANES],
+                                                                const int size, SALaneMoves *moves) {
+    const int stride = size + 1;
+    for (int l = 0; l < LANES; l++) {
+        uint32_t block = ((draw[0][l] >> 16) * b->movable[l]) >> 16;
+        const uint16_t *bounds = &b->block_start[l * stride + block];
+        uint32_t start = bounds[0], count = bounds[1] - bounds[0];
+        uint32_t i = ((draw[1][l] >> 16) * count) >> 16;
+        uint32_t j = ((draw[2][l] >> 16) * (count - 1)) >> 16;
+        j += j >= i; // druga komórka spośród pozostałych count - 1
+        uint32_t p = b->free_cells[l * b->cells + start + i], q = b->free_cells[l * b->cells + start + j];
+        uint32_t r1 = (p >> 16) & 0xFF, c1 = p >> 24, r2 = (q >> 16) & 0xFF, c2 = q >> 24;
+        uint32_t cell1 = (p & 0xFFFF) * LANES + l, cell2 = (q & 0xFFFF) * LANES + l;
+        uint32_t row1 = r1 * stride * LANES + l, row2 = r2 * stride * LANES + l;
+        uint32_t col1 = c1 * stride * LANES + l, col2 = c2 * stride * LANES + l;
+        moves->cell[0][l] = cell1;
+        moves->cell[1][l] = cell2;
+        moves->row[0][l] = row1;
+        moves->row[1][l] = row2;
+        moves->col[0][l] = col1;
+        moves->col[1][l] = col2;
+
+        // Cyfry bloku są różne, więc jak w swap_delta liczą się tylko dwa wiersze i dwie kolumny
+        int a = b->grid[cell1] * LANES, v = b->grid[cell2] * LANES;
+        const uint8_t *ra = &b->row_count[row1], *rb = &b->row_count[row2];
+        const uint8_t *ca = &b->col_count[col1], *cb = &b->col_count[col2];
+        int dr = (rb[a] > 0) - (ra[a] > 1) + (ra[v] > 0) - (rb[v] > 1);
+        int dc = (cb[a] > 0) - (ca[a] > 1) + (ca[v] > 0) - (cb[v] > 1);
+        moves->delta[l] = (r1 != r2) * dr + (c1 != c2) * dc;
+    }
+}
+
+#ifdef SA_BATCH_HAVE_AVX2
+/**
+ * Wczytuje bajty base[index] ośmiu torów instrukcją gather (odczyt 4 bajtów - tablice mają zapas)
+ */
+__attribute__((target("avx2")))
+static inline __attribute__((always_inline)) __m256i gather_bytes(const uint8_t *base, __m256i index) {
+    return _mm256_and_si256(_mm256_i32gather_epi32((const int *)base, index, 1), _mm256_set1_epi32(0xFF));
+}
+
+/**
+ * Wersja AVX2 propose_moves: wszystkie odczyty z tablic torów to instrukcje gather,
+ * po 8 torów na rejestr. Losuje te same ruchy co propose_moves.
+ */
+__attribute__((target("avx2")))
+static inline void propose_moves_avx2(const SABatch *b, uint32_t draw[][LANES], const int size, SALaneMoves *moves) {
+    const int stride = size + 1;
+    const __m256i byte = _mm256_set1_epi32(0xFF), one = _mm256_set1_epi32(1), zero = _mm256_setzero_si256();
+    for (int h = 0; h < LANES; h += 8) {
+        __m256i lane = _mm256_add_epi32(_mm256_set1_epi32(h), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i draw_block = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i *)(draw[0] + h)), 16);
+        __m256i draw_first = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i *)(draw[1] + h)), 16);
+        __m256i draw_second = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i *)(draw[2] + h)), 16);
+        __m256i movable = _mm256_loadu_si256((const __m256i *)(b->movable + h));
+
+        // Początek i koniec bloku jednym odczytem 32 bitów: block_start[k] | block_start[k + 1] << 16
+        __m256i block = _mm256_srli_epi32(_mm256_mullo_epi32(draw_block, movable), 16);
+        __m256i bounds = _mm256_i32gather_epi32((const int *)b->block_start,
+                                                _mm256_add_epi32(_mm256_mullo_epi32(lane, _mm256_set1_epi32(stride)), block), 2);
+        __m256i start = _mm256_and_si256(bounds, _mm256_set1_epi32(0xFFFF));
+        __m256i count = _mm256_sub_epi32(_mm256_srli_epi32(bounds, 16), start);
+        __m256i i = _mm256_srli_epi32(_mm256_mullo_epi32(draw_first, count), 16);
+        __m256i j = _mm256_srli_epi32(_mm256_mullo_epi32(draw_second, _mm256_sub_epi32(count, one)), 16);
+        j = _mm256_add_epi32(j, _mm256_andnot_si256(_mm256_cmpgt_epi32(i, j), one));
+        __m256i base = _mm256_add_epi32(_mm256_mullo_epi32(lane, _mm256_set1_epi32(b->cells)), start);
+        __m256i p = _mm256_i32gather_epi32((const int *)b->free_cells, _mm256_add_epi32(base, i), 4);
+        __m256i q = _mm256_i32gather_epi32((const int *)b->free_cells, _mm256_add_epi32(base, j), 4);
+
+        __m256i lanes = _mm256_set1_epi32(LANES), unit = _mm256_set1_epi32(stride * LANES);
+        __m256i r1 = _mm256_and_si256(_mm256_srli_epi32(p, 16), byte), c1 = _mm256_srli_epi32(p, 24);
+        __m256i r2 = _mm256_and_si256(_mm256_srli_epi32(q, 16), byte), c2 = _mm256_srli_epi32(q, 24);
+        __m256i cell1 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xFFFF)), lanes), lane);
+        __m256i cell2 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(q, _mm256_set1_epi32(0xFFFF)), lanes), lane);
+        __m256i row1 = _mm256_add_epi32(_mm256_mullo_epi32(r1, unit), lane);
+        __m256i row2 = _mm256_add_epi32(_mm256_mullo_epi32(r2, unit), lane);
+        __m256i col1 = _mm256_add_epi32(_mm256_mullo_epi32(c1, unit), lane);
+        __m256i col2 = _mm256_add_epi32(_mm256_mullo_epi32(c2, unit), lane);
+        _mm256_storeu_si256((__m256i *)(moves->cell[0] + h), cell1);
+        _mm256_storeu_si256((__m256i *)(moves->cell[1] + h), cell2);
+        _mm256_storeu_si256((__m256i *)(moves->row[0] + h), row1);
+        _mm256_storeu_si256((__m256i *)(moves->row[1] + h), row2);
+        _mm256_storeu_si256((__m256i *)(moves->col[0] + h), col1);
+        _mm256_storeu_si256((__m256i *)(moves->col[1] + h), col2);
+
+        __m256i a = _mm256_mullo_epi32(gather_bytes(b->grid, cell1), lanes);
+        __m256i v = _mm256_mullo_epi32(gather_bytes(b->grid, cell2), lanes);
+        // cmpgt daje -1 dla spełnionego warunku, więc znaki są odwrócone względem propose_moves
+        __m256i dr = _mm256_sub_epi32(
+            _mm256_add_epi32(_mm256_cmpgt_epi32(gather_bytes(b->row_count, _mm256_add_epi32(row1, a)), one),
+                             _mm256_cmpgt_epi32(gather_bytes(b->row_count, _mm256_add_epi32(row2, v)), one)),
+            _mm256_add_epi32(_mm256_cmpgt_epi32(gather_bytes(b->row_count, _mm256_add_epi32(row2, a)), zero),
+                             _mm256_cmpgt_epi32(gather_bytes(b->row_count, _mm256_add_epi32(row1, v)), zero)));
+        __m256i dc = _mm256_sub_epi32(
+            _mm256_add_epi32(_mm256_cmpgt_epi32(gather_bytes(b->col_count, _mm256_add_epi32(col1, a)), one),
+                             _mm256_cmpgt_epi32(gather_bytes(b->col_count, _mm256_add_epi32(col2, v)), one)),
+            _mm256_add_epi32(_mm256_cmpgt_epi32(gather_bytes(b->col_count, _mm256_add_epi32(col2, a)), zero),
+                             _mm256_cmpgt_epi32(gather_bytes(b->col_count, _mm256_add_epi32(col1, v)), zero)));
+        __m256i delta = _mm256_add_epi32(_mm256_andnot_si256(_mm256_cmpeq_epi32(r1, r2), dr),
+                                         _mm256_andnot_si256(_mm256_cmpeq_epi32(c1, c2), dc));
+        _mm256_storeu_si256((__m256i *)(moves->delta + h), delta);
+    }
+}
+#endif
+
+/**
+ * Funkcja wykonuje steps kroków wyżarzania wszystkich torów naraz. Każdy krok ma cztery fazy:
+ * - losowanie liczb (xorshift32) - wektorowo,
+ * - wybór zamiany i zmiana energii z liczników dwóch wierszy i dwóch kolumn - odczyty z tablic toru,
+ * - akceptacja Metropolisa - wektorowo, exp(x) przybliżane jako 2^(x log2 e): część całkowita
+ *   trafia do wykładnika liczby float, a ułamkowa f z (-1, 0] do wielomianu minimaksowego
+ *   stopnia 4 dla 2^f (zmierzony błąd względny w float < 7e-6),
+ * - wykonanie zamian tylko dla torów z przyjętym ruchem.
+ * Temperatura toru jest stała w obrębie wywołania - kroki kończą się przed końcem epoki.
+ * @param b - partia
+ * @param steps - liczba kroków
+ * @param size - rozmiar planszy
+ * @param gather - 1 w jądrze AVX2 (propozycje ruchów przez propose_moves_avx2)
+ */
+static inline __attribute__((always_inline)) void batch_steps(SABatch *b, int steps, const int size, const int gather) {
+    uint8_t *grid = b->grid;
+    uint8_t *row_count = b->row_count;
+    uint8_t *col_count = b->col_count;
+    const vec_i32 zero = {0};
+    const vec_f32 exp_floor = (vec_f32)zero + SA_BATCH_EXP_FLOOR;
+
+    for (int s = 0; s < steps; s++) {
+        uint32_t draw[4][LANES];
+        for (int g = 0; g < LANES; g += SA_BATCH_VEC) {
+            vec_u32 state;
+            LOAD_VEC(state, b->rng + g);
+            for (int k = 0; k < 4; k++) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                STORE_VEC(draw[k] + g, state);
+            }
+            STORE_VEC(b->rng + g, state);
+        }
+
+        SALaneMoves moves;
+#ifdef SA_BATCH_HAVE_AVX2
+        if (gather)
+            propose_moves_avx2(b, draw, size, &moves);
+        else
+#endif
+            propose_moves(b, draw, size, &moves);
+
+        int32_t accept[LANES], up[LANES];
+        for (int g = 0; g < LANES; g += SA_BATCH_VEC) {
+            vec_i32 delta, live, energy, best_energy, pending, accepted, uphill;
+            vec_f32 inv_temperature;
+            vec_u32 uniform;
+            LOAD_VEC(delta, moves.delta + g);
+            LOAD_VEC(live, b->live + g);
+            LOAD_VEC(inv_temperature, b->inv_temperature + g);
+            LOAD_VEC(uniform, draw[3] + g);
+
+            vec_f32 x = __builtin_convertvector(delta, vec_f32) * -inv_temperature;
+            // Poprawa (delta < 0) daje x > 0 - przycięcie do 0 chroni konwersję i przesunięcie przed
+            // przepełnieniem; takie ruchy i tak są przyjmowane warunkiem delta <= 0
+            vec_i32 negative = x < (vec_f32)zero;
+            x = (vec_f32)((vec_i32)x & negative);
+            vec_i32 above = x > exp_floor;
+            x = (vec_f32)(((vec_i32)x & above) | ((vec_i32)exp_floor & ~above));
+            vec_f32 t = x * 1.44269504f;
+            vec_i32 whole = __builtin_convertvector(t, vec_i32); // t <= 0, obcięcie w stronę zera: t - whole należy do (-1, 0]
+            vec_f32 f = t - __builtin_convertvector(whole, vec_f32);
+            vec_f32 probability = (vec_f32)((whole + 127) << 23) *
+                                  (0.99999741f + f * (0.69303020f + f * (0.23934107f + f * (0.05307407f + f * 0.00676708f))));
+            vec_f32 u = __builtin_convertvector((vec_i32)(uniform >> 8), vec_f32) * 0x1.0p-24f;
+            vec_i32 acc = ((delta <= zero) | (u < probability)) & live;
+            vec_i32 uphill_move = acc & (delta > zero);
+            STORE_VEC(accept + g, acc);
+            STORE_VEC(up + g, uphill_move);
+
+            LOAD_VEC(accepted, b->accepted + g);
+            LOAD_VEC(uphill, b->uphill + g);
+            accepted -= acc;
+            uphill -= uphill_move;
+            STORE_VEC(b->accepted + g, accepted);
+            STORE_VEC(b->uphill + g, uphill);
+
+            // Ruch pod górę nie poprawia minimum, a poprawa nie jest ruchem pod górę, więc
+            // aktualizacja minimum przed wykonaniem zamian nie zmienia decyzji o zapisie poniżej
+            LOAD_VEC(energy, b->energy + g);
+            LOAD_VEC(best_energy, b->best_energy + g);
+            LOAD_VEC(pending, b->best_pending + g);
+            energy += delta & acc;
+            vec_i32 improved = energy < best_energy;
+            best_energy = (energy & improved) | (best_energy & ~improved);
+            pending |= improved;
+            STORE_VEC(b->energy + g, energy);
+            STORE_VEC(b->best_energy + g, best_energy);
+            STORE_VEC(b->best_pending + g, pending);
+        }
+
+        // Lista torów z przyjętym ruchem budowana bez rozgałęzień - zamiany wykonywane są tylko dla nich
+        int moved[LANES], moved_count = 0;
+        for (int l = 0; l < LANES; l++) {
+            moved[moved_count] = l;
+            moved_count += accept[l] & 1;
+        }
+        for (int m = 0; m < moved_count; m++) {
+            int l = moved[m];
+            uint32_t cell1 = moves.cell[0][l], cell2 = moves.cell[1][l];
+            uint32_t row1 = moves.row[0][l], row2 = moves.row[1][l];
+            uint32_t col1 = moves.col[0][l], col2 = moves.col[1][l];
+            int a = grid[cell1], v = grid[cell2];
+            if (up[l] & b->best_pending[l]) {
+                // Przed wyjściem z niezapisanego minimum pod górę zapisz je
+                save_best(b, l);
+                b->best_pending[l] = 0;
+            }
+            row_count[row1 + a * LANES]--;
+            row_count[row1 + v * LANES]++;
+            row_count[row2 + v * LANES]--;
+            row_count[row2 + a * LANES]++;
+            col_count[col1 + a * LANES]--;
+            col_count[col1 + v * LANES]++;
+            col_count[col2 + v * LANES]--;
+            col_count[col2 + a * LANES]++;
+            grid[cell1] = (uint8_t)v;
+            grid[cell2] = (uint8_t)a;
+        }
+    }
+}
+
+typedef void (*SABatchKernel)(SABatch *b, int steps);
+
+// Jądra wyspecjalizowane dla typowych rozmiarów (jak SA_KERNEL w SA_algorithm.c), z wersją AVX2
+// wybieraną w czasie działania (jak w energy.c)
+#define SA_BATCH_KERNEL(N)                                   \
+    static void sa_batch_kernel_##N(SABatch *b, int steps) { \
+        batch_steps(b, steps, N, 0);                         \
+    }
+SA_BATCH_KERNEL(4)
+SA_BATCH_KERNEL(9)
+SA_BATCH_KERNEL(16)
+SA_BATCH_KERNEL(25)
+SA_BATCH_KERNEL(36)
+
+#ifdef SA_BATCH_HAVE_AVX2
+#define SA_BATCH_KERNEL_AVX2(N)                                                          \
+    __attribute__((target("avx2"))) static void sa_batch_kernel_avx2_##N(SABatch *b, int steps) { \
+        batch_steps(b, steps, N, 1);                                                     \
+    }
+SA_BATCH_KERNEL_AVX2(4)
+SA_BATCH_KERNEL_AVX2(9)
+SA_BATCH_KERNEL_AVX2(16)
+SA_BATCH_KERNEL_AVX2(25)
+SA_BATCH_KERNEL_AVX2(36)
+#endif
+
+/**
+ * Funkcja wybiera jądro partii dla rozmiaru planszy.
+ * @return jądro lub NULL dla nieobsługiwanego rozmiaru
+ */
+static SABatchKernel select_batch_kernel(int size) {
+#ifdef SA_BATCH_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        switch (size) {
+        case 4: return sa_batch_kernel_avx2_4;
+        case 9: return sa_batch_kernel_avx2_9;
+        case 16: return sa_batch_kernel_avx2_16;
+        case 25: return sa_batch_kernel_avx2_25;
+        case 36: return sa_batch_kernel_avx2_36;
+        default: return NULL;
+        }
+    }
+#endif
+    switch (size) {
+    case 4: return sa_batch_kernel_4;
+    case 9: return sa_batch_kernel_9;
+    case 16: return sa_batch_kernel_16;
+    case 25: return sa_batch_kernel_25;
+    case 36: return sa_batch_kernel_36;
+    default: return NULL;
+    }
+}
+
+/**
+ * Funkcja przepisuje stan skalarny (plansza, liczniki, tablice zmiennych pól) do toru l.
+ */
+static void scatter_state(SABatch *b, int l, const SudokuState *state) {
+    int size = b->size, stride = size + 1;
+    for (int idx = 0; idx < b->cells; idx++)
+        b->grid[idx * LANES + l] = state->grid[idx];
+    for (int k = 0; k < size * stride; k++) {
+        b->row_count[k * LANES + l] = state->row_count[k];
+        b->col_count[k * LANES + l] = state->col_count[k];
+    }
+    for (int k = 0; k < state->block_start[state->movable_blocks]; k++) {
+        uint32_t r = state->free_cells[k][0], c = state->free_cells[k][1];
+        b->free_cells[l * b->cells + k] = (r * size + c) | r << 16 | c << 24;
+    }
+    memcpy(b->block_start + l * stride, state->block_start, (state->movable_blocks + 1) * sizeof(uint16_t));
+    b->movable[l] = (uint32_t)state->movable_blocks;
+    b->energy[l] = state->energy;
+}
+
+/**
+ * Funkcja ustawia temperaturę toru l.
+ */
+static void set_temperature(SABatch *b, int l, double T) {
+    b->lanes[l].T = T;
+    b->inv_temperature[l] = (float)(1.0 / (T > SA_BATCH_MIN_TEMPERATURE ? T : SA_BATCH_MIN_TEMPERATURE));
+}
+
+/**
+ * Funkcja zapisuje wynik zagadki toru l do jej planszy i statystyk.
+ */
+static void finish_lane(SABatch *b, int l) {
+    SALane *lane = &b->lanes[l];
+    if (b->best_pending[l]) {
+        save_best(b, l);
+        b->best_pending[l] = 0;
+    }
+    int energy = b->best_energy[l];
+    memcpy(b->boards[lane->puzzle]->cells, lane->best, b->cells);
+    if (b->solved != NULL)
+        b->solved[lane->puzzle] = energy == 0;
+    b->stats.iterations += lane->iterations;
+    b->stats.accepted += b->accepted[l];
+    b->stats.rejected += lane->iterations - (long)b->accepted[l];
+    b->stats.uphill += b->uphill[l];
+    b->stats.solved += energy == 0;
+    if (energy > b->stats.best_energy)
+        b->stats.best_energy = energy;
+}
+
+/**
+ * Funkcja wstawia do toru l następną zagadkę z kolejki. Zagadki rozwiązane przez propagację
+ * ograniczeń (lub bez żadnego ruchu) są zapisywane od razu, bez zajmowania toru.
+ * @return 1 jeśli tor dostał zagadkę, 0 jeśli kolejka jest pusta (tor zostaje pusty)
+ */
+static int refill_lane(SABatch *b, int l) {
+    SALane *lane = &b->lanes[l];
+    SAChain *scratch = &b->scratch;
+    while (b->next < b->count) {
+        int puzzle = b->next++;
+        Board *board = b->boards[puzzle];
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        copyBoard(board, lane->work);
+        int forced = presolveBoard(lane->work);
+        if (forced < 0)
+            copyBoard(board, lane->work); // plansza sprzeczna - wyżarzanie minimalizuje konflikty oryginału
+        else
+            b->stats.presolved_cells += forced;
+        b->stats.presolve_seconds += seconds_since(&start);
+        if (isValidSolution(lane->work)) {
+            memcpy(board->cells, lane->work->cells, b->cells);
+            if (b->solved != NULL)
+                b->solved[puzzle] = 1;
+            b->stats.solved++;
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        chain_reset(scratch, lane->work, b->seed, b->streams != NULL ? b->streams[puzzle] : (uint64_t)puzzle);
+        double T0 = sa_calibrate_temperature(scratch);
+        b->stats.init_seconds += seconds_since(&start);
+        if (scratch->current.movable_blocks == 0) {
+            // Żaden blok nie ma dwóch zmiennych pól - losowe wypełnienie jest jedynym stanem
+            memcpy(board->cells, scratch->current.grid, b->cells);
+            if (b->solved != NULL)
+                b->solved[puzzle] = scratch->current.energy == 0;
+            b->stats.solved += scratch->current.energy == 0;
+            if (scratch->current.energy > b->stats.best_energy)
+                b->stats.best_energy = scratch->current.energy;
+            continue;
+        }
+
+        scatter_state(b, l, &scratch->current);
+        memcpy(lane->best, scratch->current.grid, b->cells);
+        lane->puzzle = puzzle;
+        lane->iterations = 0;
+        lane->epoch_steps = 0;
+        int free_cells = 0;
+        for (int idx = 0; idx < b->cells; idx++)
+            free_cells += !isFixedCell(lane->work, idx);
+        lane->epoch_length = free_cells * SA_EPOCH_MOVES_PER_CELL;
+        lane->T0 = T0;
+        lane->stagnant = 0;
+        lane->reheats = 0;
+        lane->run_best = b->energy[l];
+        lane->rng = scratch->rng;
+        set_temperature(b, l, T0);
+        b->best_energy[l] = b->energy[l];
+        b->best_pending[l] = 0;
+        b->rng[l] = (uint32_t)(rngNext(&lane->rng) >> 32) | 1; // xorshift32 wymaga niezerowego stanu
+        b->accepted[l] = 0;
+        b->uphill[l] = 0;
+        b->live[l] = -1;
+        return 1;
+    }
+
+    // Pusty tor: pola (0, 0) i (0, 1) dają poprawne losowanie, ale ruchy nigdy nie są przyjmowane (live = 0)
+    lane->puzzle = -1;
+    b->live[l] = 0;
+    b->best_pending[l] = 0;
+    b->movable[l] = 1;
+    b->block_start[l * (b->size + 1)] = 0;
+    b->block_start[l * (b->size + 1) + 1] = 2;
+    b->free_cells[l * b->cells] = 0;
+    b->free_cells[l * b->cells + 1] = 1 | 1 << 24;
+    return 0;
+}
+
+/**
+ * Funkcja kończy epokę toru l według schematu sa_run_adaptive: chłodzenie, a przy stagnacji
+ * podgrzanie w miejscu lub (po SA_MAX_REHEATS podgrzaniach) nowe losowe wypełnienie.
+ */
+static void end_epoch(SABatch *b, int l) {
+    SALane *lane = &b->lanes[l];
+    double T = lane->T * SA_EPOCH_ALPHA;
+    lane->epoch_steps = 0;
+    if (b->energy[l] < lane->run_best) {
+        lane->run_best = b->energy[l];
+        lane->stagnant = 0;
+        lane->reheats = 0;
+        set_temperature(b, l, T);
+        return;
+    }
+    if (++lane->stagnant < SA_STAGNATION_EPOCHS) {
+        set_temperature(b, l, T);
+        return;
+    }
+
+    lane->stagnant = 0;
+    if (++lane->reheats > SA_MAX_REHEATS) {
+        if (b->best_pending[l]) {
+            save_best(b, l);
+            b->best_pending[l] = 0;
+        }
+        initialize_state(&b->scratch.current, lane->work, &lane->rng);
+        scatter_state(b, l, &b->scratch.current);
+        if (b->energy[l] < b->best_energy[l]) {
+            b->best_energy[l] = b->energy[l];
+            b->best_pending[l] = -1;
+        }
+        lane->reheats = 0;
+    }
+    lane->run_best = b->energy[l];
+    set_temperature(b, l, lane->T0 * SA_REHEAT_FRACTION);
+}
+
+/**
+ * Funkcja rozwiązuje zagadki partiami: tory wykonują wspólne kroki aż do najbliższej granicy
+ * epoki lub limitu iteracji któregoś toru, po czym harmonogram każdego toru jest obsługiwany
+ * osobno, a tory z rozwiązaną lub wyczerpaną zagadką pobierają następną z kolejki.
+ * @param boards - plansze jednego rozmiaru, nadpisywane najlepszymi rozwiązaniami
+ * @param count - liczba plansz
+ * @param max_iterations - maksymalna liczba iteracji na zagadkę
+ * @param seed - ziarno bazowe
+ * @param streams - strumienie zagadek (NULL - numer zagadki)
+ * @param solved - wyniki zagadek (może być NULL)
+ * @return statystyki sumaryczne (zerowe dla nieobsługiwanego rozmiaru)
+ */
+SAStats solve_sudoku_sa_batch(Board **boards, int count, int max_iterations, uint64_t seed,
+                              const uint64_t *streams, int *solved) {
+    SAStats empty = {0};
+    SABatchKernel kernel = count > 0 ? select_batch_kernel(boards[0]->size) : NULL;
+    if (kernel == NULL)
+        return empty; // brak zagadek lub nieobsługiwany rozmiar - plansze bez zmian
+    SABatch *b = calloc(1, sizeof(SABatch));
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int size = boards[0]->size;
+    b->size = size;
+    b->cells = size * size;
+    b->grid = calloc((size_t)b->cells * LANES + SA_BATCH_GATHER_PAD, 1);
+    b->row_count = calloc((size_t)size * (size + 1) * LANES + SA_BATCH_GATHER_PAD, 1);
+    b->col_count = calloc((size_t)size * (size + 1) * LANES + SA_BATCH_GATHER_PAD, 1);
+    b->free_cells = malloc((size_t)b->cells * LANES * sizeof(uint32_t));
+    b->block_start = malloc((size_t)(size + 1) * LANES * sizeof(uint16_t));
+    for (int l = 0; l < LANES; l++) {
+        b->lanes[l].work = allocateBoard(size);
+        b->lanes[l].best = malloc(b->cells);
+    }
+    chain_init(&b->scratch, boards[0], seed, 0);
+    b->boards = boards;
+    b->count = count;
+    b->seed = seed;
+    b->streams = streams;
+    b->solved = solved;
+
+    int active = 0;
+    for (int l = 0; l < LANES; l++)
+        active += refill_lane(b, l);
+
+    while (active > 0) {
+        // Wspólne kroki kończą się na najbliższej granicy epoki lub limicie któregoś toru
+        int steps = SA_BATCH_CHUNK;
+        for (int l = 0; l < LANES; l++) {
+            if (!b->live[l])
+                continue;
+            SALane *lane = &b->lanes[l];
+            int left = lane->epoch_length - lane->epoch_steps;
+            if (left < steps) steps = left;
+            left = max_iterations - lane->iterations;
+            if (left < steps) steps = left;
+        }
+        if (steps > 0)
+            kernel(b, steps);
+
+        for (int l = 0; l < LANES; l++) {
+            if (!b->live[l])
+                continue;
+            SALane *lane = &b->lanes[l];
+            lane->iterations += steps;
+            lane->epoch_steps += steps;
+            if (b->best_energy[l] == 0 || lane->iterations >= max_iterations) {
+                finish_lane(b, l);
+                active -= !refill_lane(b, l);
+                continue;
+            }
+            if (lane->epoch_steps >= lane->epoch_length)
+                end_epoch(b, l);
+        }
+    }
+    b->stats.anneal_seconds = seconds_since(&start) - b->stats.presolve_seconds - b->stats.init_seconds;
+
+    SAStats stats = b->stats;
+    for (int l = 0; l < LANES; l++) {
+        freeBoard(b->lanes[l].work);
+        free(b->lanes[l].best);
+    }
+    chain_free(&b->scratch);
+    free(b->grid);
+    free(b->row_count);
+    free(b->col_count);
+    free(b->free_cells);
+    free(b->block_start);
+    free(b);
+    return stats;
+}
@@ -0,0 +1,93 @@
+/**
+ * Wewnętrzne struktury i funkcje algorytmu wyżarzania.
+ * Nagłówek nie jest częścią publicznego API - korzystają z niego
+ * SA_algorithm.c, SA_batch.c oraz program pomiarowy bench.c.
+ */
+#ifndef SA_INTERNAL_H
+#define SA_INTERNAL_H
+
+#include <stdatomic.h>
+#include <time.h>
+#include "board.h"
+#include "rng.h"
+#include "SA_algorithm.h"
+
+// Schemat adaptacyjny (sa_run_adaptive i wyżarzanie partiami w SA_batch.c)
+#define SA_EPOCH_MOVES_PER_CELL 20 // długość epoki (w ruchach) na jedno zmienne pole
+#define SA_EPOCH_ALPHA 0.85 // współczynnik chłodzenia po każdej epoce
+#define SA_STAGNATION_EPOCHS 3 // liczba epok bez poprawy, po której następuje podgrzanie
+#define SA_MAX_REHEATS 5 // liczba kolejnych nieudanych podgrzań przed losowym restartem
+#define SA_REHEAT_FRACTION 0.3 // temperatura po podgrzaniu jako ułamek T0
+
+typedef struct {
+    uint8_t *grid; // aktualna plansza Sudoku (ciągła, wierszami)
+    int energy; // energia - ilosc konfliktów
+    int size; // rozmiar planszy
+    int box_size; // rozmiar pojedynczego podkwadratu
+    uint8_t *row_count; // liczniki cyfr w wierszach: row_count[r * (size + 1) + cyfra]
+    uint8_t *col_count; // liczniki cyfr w kolumnach: col_count[c * (size + 1) + cyfra]
+    uint8_t (*free_cells)[2]; // współrzędne (r, c) zmiennych pól bloków z ruchami, blok po bloku
+    uint16_t *block_start; // zmienne pola k-tego bloku z ruchami: free_cells[block_start[k]..block_start[k + 1])
+    int movable_blocks; // liczba bloków z co najmniej dwoma zmiennymi polami
+} SudokuState;
+
+typedef struct {
+    int r1, c1; // pierwsza zamieniana komórka
+    int r2, c2; // druga zamieniana komórka
+    int delta;  // zmiana energii po wykonaniu zamiany
+} SwapMove;
+
+typedef struct {
+    SudokuState current; // stan, na którym wykonywane są ruchy
+    uint8_t *best; // najlepsza zapisana plansza
+    int best_energy; // energia najlepszego stanu
+    int best_pending; // 1 gdy aktualny stan jest nowym minimum jeszcze nie skopiowanym do best
+    Rng rng; // własny generator liczb losowych łańcucha
+    long iterations; // wykonane iteracje
+    long accepted; // zaakceptowane ruchy
+    long rejected; // odrzucone ruchy
+    long uphill; // zaakceptowane ruchy zwiększające energię
+    int finish_attempts; // próby dokończenia planszy solverem dokładnym
+    int finished_exact; // 1 gdy best pochodzi z solvera dokładnego
+} SAChain;
+
+/** Pełne przeliczenie energii planszy (powtórzenia w wierszach, kolumnach i blokach) */
+int calculate_energy(const uint8_t *grid, int size);
+/** Przeliczenie od zera liczników cyfr w wierszach i kolumnach */
+void init_counts(SudokuState *state);
+/** Zmiana energii po zamianie dwóch komórek jednego bloku */
+int swap_delta(const SudokuState *state, int r1, int c1, int r2, int c2);
+/** Wykonanie zamiany wraz z aktualizacją liczników */
+void apply_swap(SudokuState *state, int r1, int c1, int r2, int c2);
+/** Alokacja planszy i liczników stanu */
+void alloc_state(SudokuState *state, int size);
+/** Losowe wypełnienie bloków brakującymi cyframi i zbudowanie tablic zmiennych pól */
+void initialize_state(SudokuState *state, const Board *initial, Rng *rng);
+/** Propozycja ruchu (bez modyfikacji stanu); 0 jeśli żaden blok nie ma dwóch zmiennych pól */
+int generate_neighbor(const SudokuState *current, SwapMove *move, Rng *rng);
+/** Zwolnienie pamięci stanu */
+void free_state(SudokuState *state);
+
+/** Przygotowanie łańcucha wyżarzania ze strumieniem stream generatora o ziarnie seed */
+void chain_init(SAChain *chain, const Board *board, uint64_t seed, uint64_t stream);
+/** Ponowne przygotowanie łańcucha dla planszy tego samego rozmiaru (bez alokacji) */
+void chain_reset(SAChain *chain, const Board *board, uint64_t seed, uint64_t stream);
+/** Zapisanie niezapisanego minimum do chain->best */
+void chain_flush_best(SAChain *chain);
+/** Zwolnienie pamięci łańcucha */
+void chain_free(SAChain *chain);
+/** Geometryczne chłodzenie łańcucha; zwraca liczbę wykonanych iteracji */
+int sa_run(SAChain *chain, double T_start, double T_end, double alpha, int max_iterations, const SAMonitor *monitor);
+/** Temperatura początkowa: odchylenie standardowe zmian energii próbnych ruchów */
+double sa_calibrate_temperature(SAChain *chain);
+/** Adaptacyjne chłodzenie po epokach z podgrzewaniem przy stagnacji (do limitu, flagi stop lub terminu); zwraca liczbę iteracji */
+int sa_run_adaptive(SAChain *chain, const Board *board, int max_iterations, atomic_int *stop,
+                    const struct timespec *deadline, const SAMonitor *monitor, int hybrid);
+/** Dokończenie planszy grid solverem dokładnym po wyczyszczeniu pól w konflikcie; 1 przy sukcesie */
+int sa_exact_finish(SAChain *chain, const Board *board, const uint8_t *grid, long node_limit);
+/** Dodanie liczników łańcucha do statystyk */
+void chain_add_stats(const SAChain *chain, SAStats *stats);
+/** Czas w sekundach od chwili start (CLOCK_MONOTONIC) */
+double seconds_since(const struct timespec *start);
+
+#endif
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "batch.h"
+#include "board.h"
+#include "generateboard.h"
+#include "presolve.h"
+
+#define BATCH_BUFFER_SIZE (64 * 1024) // największy rozmiar fragmentu wyjścia (bufora wątku)
+#define BATCH_CHUNKS_PER_THREAD 4 // najmniejsza liczba fragmentów na wątek
+#define BATCH_RATED_ATTEMPTS 50 // limit plansz generowanych dla jednej zagadki o zadanej ocenie
+
+typedef struct {
+    int count; // liczba zagadek do wygenerowania
+    int size; // rozmiar planszy
+    int holes; // liczba pustych pól
+    int grade; // żądana ocena logiczna (GRADE_*); 0 - zagadki według liczby luk
+    int generator; // metoda generowania pełnej planszy (GENERATOR_*)
+    uint64_t seed; // ziarno bazowe
+    int chunkPuzzles; // liczba zagadek w jednym fragmencie
+    int chunkCount; // liczba fragmentów
+    atomic_int next; // numer następnego fragmentu do pobrania przez wątek
+    atomic_int failed; // liczba zagadek, których plansza nie powstała w limicie czasu
+    FILE *out; // plik wynikowy
+    int written; // liczba fragmentów zapisanych do pliku
+    pthread_mutex_t outMutex; // chroni zapis do pliku i written
+    pthread_cond_t chunkWritten; // sygnalizowane po zapisaniu fragmentu
+} BatchJob;
+
+/**
+ * Zapisuje fragment do pliku wynikowego po zapisaniu wszystkich wcześniejszych,
+ * dzięki czemu linie trafiają do pliku w kolejności numerów zagadek
+ * @param job - wspólne dane zadania
+ * @param chunk - numer fragmentu
+ * @param buffer - bufor z gotowymi liniami
+ * @param len - długość danych w buforze
+ */
+static void writeChunk(BatchJob *job, int chunk, const char *buffer, size_t len) {
+    pthread_mutex_lock(&job->outMutex);
+    while (job->written != chunk)
+        pthread_cond_wait(&job->chunkWritten, &job->outMutex);
+    fwrite(buffer, 1, len, job->out);
+    job->written++;
+    pthread_cond_broadcast(&job->chunkWritten);
+    pthread_mutex_unlock(&job->outMutex);
+}
+
+/**
+ * Dopisuje komórki planszy do bufora jako znaki
+ * @param dest - miejsce w buforze
+ * @param board - plansza
+ * @return liczba zapisanych znaków
+ */
+static size_t formatBoard(char *dest, const Board *board) {
+    int n = board->size * board->size;
+    for (int idx = 0; idx < n; idx++)
+        dest[idx] = cellToChar(board->cells[idx]);
+    return n;
+}
+
+/**
+ * Funkcja wątku roboczego: pobiera kolejne fragmenty (ciągłe zakresy numerów zagadek)
+ * aż do wyczerpania puli i zapisuje je w kolejności fragmentów
+ * @param arg - wskaźnik na BatchJob
+ */
+static void *batchWorker(void *arg) {
+    BatchJob *job = arg;
+    Board *solution = allocateBoard(job->size);
+    Board *puzzle = allocateBoard(job->size);
+    int lineLen = 2 * job->size * job->size + 2;
+    char *buffer = malloc((size_t)job->chunkPuzzles * lineLen);
+
+    while (1) {
+        int chunk = atomic_fetch_add(&job->next, 1);
+        if (chunk >= job->chunkCount)
+            break;
+        int first = chunk * job->chunkPuzzles;
+        int last = first + job->chunkPuzzles < job->count ? first + job->chunkPuzzles : job->count;
+        size_t used = 0;
+        for (int i = first; i < last; i++) {
+            // Strumień generatora zależny tylko od numeru zagadki - wynik nie zależy od liczby wątków
+            Rng rng;
+            rngSeedStream(&rng, job->seed, (uint64_t)i);
+
+            if (job->grade > 0) {
+                if (generateRated(solution, puzzle, job->grade, &rng, BATCH_RATED_ATTEMPTS) == 0) {
+                    atomic_fetch_add(&job->failed, 1);
+                    continue;
+                }
+            } else {
+                if (!generateGrid(solution, job->generator, &rng)) {
+                    atomic_fetch_add(&job->failed, 1);
+                    continue;
+                }
+                copyBoard(solution, puzzle);
+                for (int idx = 0; idx < job->size * job->size; idx++)
+                    setFixedCell(puzzle, idx, 1);
+                removeCells(puzzle, job->holes, &rng);
+            }
+
+            used += formatBoard(buffer + used, puzzle);
+            buffer[used++] = ' ';
+            used += formatBoard(buffer + used, solution);
+            buffer[used++] = '\n';
+        }
+        writeChunk(job, chunk, buffer, used);
+    }
+
+    free(buffer);
+    freeBoard(puzzle);
+    freeBoard(solution);
+    return NULL;
+}
+
+/**
+ * Generuje count zagadek na puli wątków i zapisuje je strumieniowo do pliku
+ * @param count - liczba zagadek
+ * @param size - rozmiar planszy (4, 9, 16, 25 lub 36)
+ * @param holes - liczba pustych pól w każdej zagadce
+ * @param grade - żądana ocena logiczna (GRADE_*); 0 - zagadki według liczby luk
+ * @param generator - metoda generowania pełnej planszy (GENERATOR_*)
+ * @param threads - liczba wątków roboczych
+ * @param path - ścieżka pliku wynikowego
+ * @param seed - ziarno bazowe
+ * @return 0 w przypadku powodzenia, 1 w przypadku błędu
+ */
+int runBatch(int count, int size, int holes, int grade, int generator, int threads, const char *path, uint64_t seed) {
+    if (threads < 1) threads = 1;
+
+    BatchJob job;
+    job.count = count;
+    job.size = size;
+    job.holes = holes;
+    job.grade = grade;
+    job.generator = generator;
+    job.seed = seed;
+    int lineLen = 2 * size * size + 2;
+    // Przynajmniej kilka fragmentów na wątek, żeby wątki nie czekały długo na zapis poprzednika
+    int perThread = count / (threads * BATCH_CHUNKS_PER_THREAD);
+    job.chunkPuzzles = BATCH_BUFFER_SIZE / lineLen;
+    if (job.chunkPuzzles > perThread)
+        job.chunkPuzzles = perThread;
+    if (job.chunkPuzzles < 1)
+        job.chunkPuzzles = 1;
+    job.chunkCount = (count + job.chunkPuzzles - 1) / job.chunkPuzzles;
+    job.written = 0;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.failed, 0);
+    job.out = fopen(path, "w");
+    if (job.out == NULL) {
+        perror(path);
+        return 1;
+    }
+    pthread_mutex_init(&job.outMutex, NULL);
+    pthread_cond_init(&job.chunkWritten, NULL);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t workers[threads];
+    for (int t = 0; t < threads; t++)
+        pthread_create(&workers[t], NULL, batchWorker, &job);
+    for (int t = 0; t < threads; t++)
+        pthread_join(workers[t], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    int failed = fclose(job.out) != 0;
+    pthread_mutex_destroy(&job.outMutex);
+    pthread_cond_destroy(&job.chunkWritten);
+    if (failed) {
+        perror(path);
+        return 1;
+    }
+
+    int skipped = atomic_load(&job.failed);
+    if (skipped > 0) {
+        fprintf(stderr, "Nie udało się wygenerować %d z %d plansz w limicie czasu - pominięto je\n", skipped, count);
+        return 1;
+    }
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Wygenerowano %d plansz %dx%d w %.3f s (%.1f plansz/s, wątki: %d)\n",
+           count, size, size, seconds, seconds > 0 ? count / seconds : 0.0, threads);
+    return 0;
+}
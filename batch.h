@@ -0,0 +1,29 @@
+/**
+ * Deklaracja nieinteraktywnego trybu wsadowego:
+ * równoległe generowanie wielu zagadek Sudoku do pliku.
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+
+/**
+ * Generuje count zagadek na puli wątków i zapisuje je strumieniowo do pliku.
+ * Każda linia pliku ma postać "<zagadka> <rozwiązanie>", gdzie pola zapisane są
+ * znakami z cellToChar ('.' oznacza puste pole). Linie zapisywane są w kolejności numerów zagadek.
+ * Na koniec wypisuje przepustowość w planszach na sekundę.
+ * @param count - liczba zagadek
+ * @param size - rozmiar planszy (4, 9, 16, 25 lub 36)
+ * @param holes - liczba pustych pól w każdej zagadce (ignorowana, gdy grade > 0)
+ * @param grade - żądana ocena logiczna (GRADE_* z presolve.h); zagadki są wtedy
+ *                jednoznaczne i wycinane generateRated; 0 - według liczby luk
+ * @param generator - metoda generowania pełnej planszy (GENERATOR_* z generateboard.h)
+ * @param threads - liczba wątków roboczych
+ * @param path - ścieżka pliku wynikowego
+ * @param seed - ziarno bazowe; zagadka nr i zależy tylko od (seed, i)
+ * @return 0 w przypadku powodzenia, 1 w przypadku błędu (także gdy któraś plansza
+ *         nie powstała w limicie czasu generateBoard - jej linia jest pominięta)
+ */
+int runBatch(int count, int size, int holes, int grade, int generator, int threads, const char *path, uint64_t seed);
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * Program pomiarowy (mikrobenchmarki) generatora, funkcji energii i algorytmu wyżarzania.
+ * Wyniki wypisywane są jako linie JSON (jedna linia na pomiar), aby łatwo je porównywać
+ * między wersjami i wykrywać regresje.
+ *
+ * Użycie: ./bench [powtórzenia]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "board.h"
+#include "generateboard.h"
+#include "SA_algorithm.h"
+#include "SA_internal.h"
+#include "presolve.h"
+
+#define BENCH_BATCH 1000 // liczba wywołań szybkich funkcji mierzonych razem (narzut zegara)
+#define BENCH_SA_PUZZLES 20 // liczba zagadek w korpusie SA
+#define BENCH_SA_HOLES 45 // liczba pustych pól zagadek w korpusie SA
+#define BENCH_SEED 12345u // ziarno korpusu - ten sam korpus w każdym uruchomieniu
+
+/**
+ * Zwraca czas monotoniczny w nanosekundach
+ */
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Porównanie liczb dla qsort
+ */
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Wypisuje medianę i 99. percentyl serii pomiarów jako linię JSON
+ * @param name - nazwa pomiaru
+ * @param size - rozmiar planszy
+ * @param samples - czasy pojedynczych operacji w nanosekundach (zostaną posortowane)
+ * @param n - liczba próbek
+ */
+static void report(const char *name, int size, double *samples, int n) {
+    qsort(samples, n, sizeof(double), compareDouble);
+    double median = samples[n / 2];
+    double p99 = samples[(int)((n - 1) * 0.99)];
+    printf("{\"bench\":\"%s\",\"size\":%d,\"samples\":%d,\"median_ns\":%.1f,\"p99_ns\":%.1f,\"ops_per_sec\":%.1f}\n",
+           name, size, n, median, p99, median > 0 ? 1e9 / median : 0.0);
+}
+
+/**
+ * Tworzy zagadkę z korpusu: pełna plansza z ziarna i usunięte pola
+ * @param board - plansza wynikowa
+ * @param rng - generator liczb losowych
+ * @param holes - liczba pustych pól
+ */
+static void makePuzzle(Board *board, Rng *rng, int holes) {
+    if (!generateBoard(board, rng)) {
+        fprintf(stderr, "Nie udało się wygenerować planszy %dx%d w limicie czasu\n", board->size, board->size);
+        exit(1);
+    }
+    for (int idx = 0; idx < board->size * board->size; idx++)
+        setFixedCell(board, idx, 1);
+    removeCells(board, holes, rng);
+}
+
+/**
+ * Mierzy czas generowania pełnej planszy podanego rozmiaru wybraną metodą (GENERATOR_*)
+ */
+static void benchGenerate(int size, int reps, int generator) {
+    Board *board = allocateBoard(size);
+    double *samples = malloc(reps * sizeof(double));
+    Rng rng;
+    rngSeed(&rng, BENCH_SEED);
+    for (int i = 0; i < reps; i++) {
+        double start = nowNs();
+        int generated = generateGrid(board, generator, &rng);
+        samples[i] = nowNs() - start;
+        if (!generated) {
+            fprintf(stderr, "Nie udało się wygenerować planszy %dx%d w limicie czasu\n", size, size);
+            exit(1);
+        }
+    }
+    report(generator == GENERATOR_TRANSFORM ? "generateBoardTransformed" : "generateBoard", size, samples, reps);
+    free(samples);
+    freeBoard(board);
+}
+
+/**
+ * Mierzy czas calculate_energy i generate_neighbor na stanach początkowych SA.
+ * Pojedyncze wywołania są zbyt krótkie dla zegara, więc próbką jest średnia z BENCH_BATCH wywołań.
+ */
+static void benchKernels(int size, int reps) {
+    Board *board = allocateBoard(size);
+    Rng rng;
+    rngSeed(&rng, BENCH_SEED);
+    makePuzzle(board, &rng, size * size / 2);
+
+    SudokuState state;
+    alloc_state(&state, size);
+    initialize_state(&state, board, &rng);
+
+    double *samples = malloc(reps * sizeof(double));
+    volatile int sink = 0;
+    for (int i = 0; i < reps; i++) {
+        double start = nowNs();
+        for (int k = 0; k < BENCH_BATCH; k++)
+            sink += calculate_energy(state.grid, size);
+        samples[i] = (nowNs() - start) / BENCH_BATCH;
+    }
+    report("calculate_energy", size, samples, reps);
+
+    SwapMove move;
+    for (int i = 0; i < reps; i++) {
+        double start = nowNs();
+        for (int k = 0; k < BENCH_BATCH; k++)
+            sink += generate_neighbor(&state, &move, &rng) ? move.delta : 0;
+        samples[i] = (nowNs() - start) / BENCH_BATCH;
+    }
+    report("generate_neighbor", size, samples, reps);
+    (void)sink;
+
+    free(samples);
+    free_state(&state);
+    freeBoard(board);
+}
+
+/**
+ * Mierzy pełne uruchomienia SA na stałym korpusie zagadek 9x9: schemat geometryczny
+ * (T_start = 5.0, T_end = 1e-3, alpha = 0.999) lub adaptacyjny z limitem 1000000 iteracji
+ * @param adaptive - 1 dla sa_run_adaptive, 0 dla sa_run
+ */
+static void benchSolve(int adaptive) {
+    const char *name = adaptive ? "solve_sudoku_sa_adaptive" : "solve_sudoku_sa";
+    int size = 9;
+    Board *board = allocateBoard(size);
+    double samples[BENCH_SA_PUZZLES];
+    long totalIterations = 0;
+    double totalNs = 0;
+    int solved = 0;
+    Rng rng;
+    rngSeed(&rng, BENCH_SEED);
+
+    for (int i = 0; i < BENCH_SA_PUZZLES; i++) {
+        makePuzzle(board, &rng, BENCH_SA_HOLES);
+        SAChain chain;
+        double start = nowNs();
+        chain_init(&chain, board, BENCH_SEED, (uint64_t)i);
+        if (adaptive)
+            totalIterations += sa_run_adaptive(&chain, board, 1000000, NULL, NULL, NULL, 0);
+        else
+            totalIterations += sa_run(&chain, 5.0, 1e-3, 0.999, 1000000, NULL);
+        samples[i] = nowNs() - start;
+        totalNs += samples[i];
+        solved += chain.best_energy == 0;
+        chain_free(&chain);
+    }
+
+    report(name, size, samples, BENCH_SA_PUZZLES);
+    printf("{\"bench\":\"%s_totals\",\"size\":%d,\"puzzles\":%d,\"solved\":%d,"
+           "\"iterations\":%ld,\"iterations_per_sec\":%.1f}\n",
+           name, size, BENCH_SA_PUZZLES, solved, totalIterations, totalNs > 0 ? totalIterations / (totalNs / 1e9) : 0.0);
+    freeBoard(board);
+}
+
+/**
+ * Mierzy wyżarzanie partiami (solve_sudoku_sa_batch) na tym samym korpusie zagadek 9x9
+ * rozwiązywanym jednym wywołaniem (z propagacją ograniczeń, limit 1000000 iteracji na zagadkę)
+ */
+static void benchSolveBatch(void) {
+    int size = 9;
+    Board *boards[BENCH_SA_PUZZLES];
+    Rng rng;
+    rngSeed(&rng, BENCH_SEED);
+    for (int i = 0; i < BENCH_SA_PUZZLES; i++) {
+        boards[i] = allocateBoard(size);
+        makePuzzle(boards[i], &rng, BENCH_SA_HOLES);
+    }
+
+    double start = nowNs();
+    SAStats stats = solve_sudoku_sa_batch(boards, BENCH_SA_PUZZLES, 1000000, BENCH_SEED, NULL, NULL);
+    double totalNs = nowNs() - start;
+
+    printf("{\"bench\":\"solve_sudoku_sa_batch_totals\",\"size\":%d,\"puzzles\":%d,\"solved\":%d,"
+           "\"iterations\":%ld,\"iterations_per_sec\":%.1f,\"puzzles_per_sec\":%.1f}\n",
+           size, BENCH_SA_PUZZLES, stats.solved, stats.iterations,
+           stats.anneal_seconds > 0 ? stats.iterations / stats.anneal_seconds : 0.0,
+           totalNs > 0 ? BENCH_SA_PUZZLES / (totalNs / 1e9) : 0.0);
+    for (int i = 0; i < BENCH_SA_PUZZLES; i++)
+        freeBoard(boards[i]);
+}
+
+/**
+ * Mierzy propagację ograniczeń (presolve) na tym samym korpusie zagadek 9x9
+ * i zlicza zagadki rozwiązane bez wyżarzania
+ */
+static void benchPresolve(void) {
+    int size = 9;
+    Board *board = allocateBoard(size);
+    double samples[BENCH_SA_PUZZLES];
+    int solved = 0;
+    long forced = 0;
+    Rng rng;
+    rngSeed(&rng, BENCH_SEED);
+
+    for (int i = 0; i < BENCH_SA_PUZZLES; i++) {
+        makePuzzle(board, &rng, BENCH_SA_HOLES);
+        double start = nowNs();
+        int filled = presolveBoard(board);
+        samples[i] = nowNs() - start;
+        forced += filled > 0 ? filled : 0;
+        solved += filled >= 0 && memchr(board->cells, 0, size * size) == NULL;
+    }
+
+    report("presolveBoard", size, samples, BENCH_SA_PUZZLES);
+    printf("{\"bench\":\"presolveBoard_totals\",\"size\":%d,\"puzzles\":%d,\"solved\":%d,\"forced_cells\":%ld,"
+           "\"holes\":%d}\n",
+           size, BENCH_SA_PUZZLES, solved, forced, BENCH_SA_PUZZLES * BENCH_SA_HOLES);
+    freeBoard(board);
+}
+
+/**
+ * Główna funkcja programu pomiarowego
+ */
+int main(int argc, char **argv) {
+    int reps = argc > 1 ? atoi(argv[1]) : 200;
+    if (reps < 1) reps = 1;
+
+    int sizes[] = {4, 9, 16, 25, 36};
+    int count = sizeof(sizes) / sizeof(sizes[0]);
+    for (int i = 0; i < count; i++)
+        benchGenerate(sizes[i], reps, GENERATOR_BACKTRACK);
+    for (int i = 0; i < count; i++)
+        benchGenerate(sizes[i], reps, GENERATOR_TRANSFORM);
+    for (int i = 0; i < count; i++)
+        benchKernels(sizes[i], reps);
+    benchSolve(0);
+    benchSolve(1);
+    benchSolveBatch();
+    benchPresolve();
+    return 0;
+}
@@ -0,0 +1,339 @@
+#include <string.h>
+#include <time.h>
+#include "bitsolver.h"
+
+#define POPCOUNT(x) __builtin_popcountll(x)
+#define CTZ(x) __builtin_ctzll(x)
+#define MAX_CELLS (MAX_SIZE * MAX_SIZE) // maksymalna liczba pól planszy
+#define TIME_CHECK_MASK 63 // zegar sprawdzany co 64 węzły (węzeł jest dużo droższy od odczytu zegara)
+
+typedef struct {
+    int size;           // rozmiar planszy
+    uint64_t full;      // maska wszystkich cyfr: bit (d - 1) oznacza cyfrę d
+    uint64_t rows[64];  // cyfry użyte w wierszach
+    uint64_t cols[64];  // cyfry użyte w kolumnach
+    uint64_t boxes[64]; // cyfry użyte w podkwadratach
+    uint8_t *cells;     // komórki rozwiązywanej planszy
+    uint8_t rowOf[MAX_CELLS]; // numer wiersza dla indeksu pola
+    uint8_t colOf[MAX_CELLS]; // numer kolumny dla indeksu pola
+    uint8_t boxOf[MAX_CELLS]; // numer podkwadratu dla indeksu pola
+    int16_t empty[MAX_CELLS]; // indeksy pustych pól; [0, depth) są już wypełnione
+    uint64_t stack[MAX_CELLS + 1]; // stos przeszukiwania: kandydaci jeszcze do sprawdzenia w polu empty[d]
+    int emptyCount;     // liczba pustych pól
+    Rng *rng;           // generator do losowej kolejności kandydatów (NULL - kolejność stała)
+    int limit;          // 0 - szukaj jednego rozwiązania i zostaw je, >0 - licz do limitu
+    int solutions;      // liczba znalezionych rozwiązań
+    long nodes;         // liczba odwiedzonych węzłów przeszukiwania
+    long nodeLimit;     // limit węzłów (0 - bez limitu)
+    double deadline;    // czas monotoniczny końca przeszukiwania w sekundach (0 - bez limitu)
+    int aborted;        // 1 po przekroczeniu limitu węzłów lub czasu
+} BitSolver;
+
+/**
+ * Zwraca czas monotoniczny w sekundach
+ */
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Przygotowuje maski i listę pustych pól dla planszy (bez alokacji - kontekst
+ * mieści planszę 36x36)
+ * @param s - kontekst solvera
+ * @param board - plansza wejściowa
+ * @param cells - bufor komórek, na którym działa przeszukiwanie
+ * @return 1 jeśli pola stałe są niesprzeczne, 0 w przeciwnym wypadku
+ */
+static int initSolver(BitSolver *s, const Board *board, uint8_t *cells) {
+    int size = board->size;
+    int boxSize = board->box_size;
+    int n = size * size;
+
+    s->size = size;
+    s->full = size == 64 ? ~(uint64_t)0 : ((uint64_t)1 << size) - 1;
+    memset(s->rows, 0, sizeof(s->rows));
+    memset(s->cols, 0, sizeof(s->cols));
+    memset(s->boxes, 0, sizeof(s->boxes));
+    s->cells = cells;
+    s->emptyCount = 0;
+    s->solutions = 0;
+    s->nodes = 0;
+    s->nodeLimit = 0;
+    s->deadline = 0;
+    s->aborted = 0;
+
+    for (int idx = 0; idx < n; idx++) {
+        int r = idx / size, c = idx % size;
+        int b = (r / boxSize) * boxSize + c / boxSize;
+        s->rowOf[idx] = (uint8_t)r;
+        s->colOf[idx] = (uint8_t)c;
+        s->boxOf[idx] = (uint8_t)b;
+
+        int val = cells[idx];
+        if (val == 0) {
+            s->empty[s->emptyCount++] = (int16_t)idx;
+            continue;
+        }
+        uint64_t bit = (uint64_t)1 << (val - 1);
+        // ta sama cyfra dwa razy w jednej jednostce - plansza sprzeczna
+        if ((s->rows[r] | s->cols[c] | s->boxes[b]) & bit)
+            return 0;
+        s->rows[r] |= bit;
+        s->cols[c] |= bit;
+        s->boxes[b] |= bit;
+    }
+    return 1;
+}
+
+/**
+ * Zwraca maskę kandydatów dla pustego pola
+ */
+static inline uint64_t candidatesOf(const BitSolver *s, int idx) {
+    return s->full & ~(s->rows[s->rowOf[idx]] | s->cols[s->colOf[idx]] | s->boxes[s->boxOf[idx]]);
+}
+
+/**
+ * Wybiera losowy ustawiony bit maski
+ * @param mask - niepusta maska
+ * @param rng - generator liczb losowych
+ * @return maska z jednym bitem
+ */
+static uint64_t randomBit(uint64_t mask, Rng *rng) {
+    int k = rngBounded(rng, POPCOUNT(mask));
+    while (k-- > 0)
+        mask &= mask - 1; // usuń najniższy bit
+    return mask & -mask;
+}
+
+/**
+ * Wybiera pole, na którym przeszukiwanie się rozgałęzi.
+ * Domyślnie jest to pole z najmniejszą liczbą kandydatów (MRV). Jeśli takie pole ma
+ * więcej niż jednego kandydata, sprawdzane są jeszcze ukryte single: cyfra, która
+ * w danej jednostce pasuje tylko do jednego pola, daje gałąź bez rozwidlenia.
+ * @param s - kontekst solvera
+ * @param depth - liczba już wypełnionych pustych pól
+ * @param outPos - pozycja wybranego pola w tablicy empty
+ * @param outMask - kandydaci do sprawdzenia w wybranym polu
+ * @return 0 jeśli stan jest sprzeczny (pole bez kandydatów lub cyfra bez miejsca w jednostce)
+ */
+static int chooseBranch(const BitSolver *s, int depth, int *outPos, uint64_t *outMask) {
+    int bestPos = depth;
+    int bestCount = 65;
+    uint64_t bestMask = 0;
+
+    for (int pos = depth; pos < s->emptyCount; pos++) {
+        uint64_t mask = candidatesOf(s, s->empty[pos]);
+        int count = POPCOUNT(mask);
+        if (count < bestCount) {
+            bestCount = count;
+            bestPos = pos;
+            bestMask = mask;
+            if (count <= 1)
+                break; // nagi singiel lub sprzeczność - lepszego wyboru nie będzie
+        }
+    }
+    if (bestCount == 0)
+        return 0;
+
+    if (bestCount > 1) {
+        // once/twice - cyfry pasujące do co najmniej jednego / dwóch pustych pól jednostki
+        uint64_t once[3][64], twice[3][64];
+        for (int k = 0; k < 3; k++) {
+            memset(once[k], 0, s->size * sizeof(uint64_t));
+            memset(twice[k], 0, s->size * sizeof(uint64_t));
+        }
+        for (int pos = depth; pos < s->emptyCount; pos++) {
+            int idx = s->empty[pos];
+            uint64_t mask = candidatesOf(s, idx);
+            int unit[3] = { s->rowOf[idx], s->colOf[idx], s->boxOf[idx] };
+            for (int k = 0; k < 3; k++) {
+                twice[k][unit[k]] |= once[k][unit[k]] & mask;
+                once[k][unit[k]] |= mask;
+            }
+        }
+
+        const uint64_t *used[3] = { s->rows, s->cols, s->boxes };
+        for (int k = 0; k < 3; k++) {
+            for (int u = 0; u < s->size; u++) {
+                uint64_t missing = s->full & ~used[k][u];
+                if (missing & ~once[k][u])
+                    return 0; // brakującej cyfry nie da się nigdzie wstawić
+                uint64_t hidden = once[k][u] & ~twice[k][u];
+                if (hidden == 0)
+                    continue;
+                uint64_t bit = hidden & -hidden;
+                // Znajdź jedyne pole jednostki, do którego pasuje ta cyfra
+                for (int pos = depth; pos < s->emptyCount; pos++) {
+                    int idx = s->empty[pos];
+                    int unitOf = k == 0 ? s->rowOf[idx] : k == 1 ? s->colOf[idx] : s->boxOf[idx];
+                    if (unitOf == u && (candidatesOf(s, idx) & bit)) {
+                        *outPos = pos;
+                        *outMask = bit;
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    *outPos = bestPos;
+    *outMask = bestMask;
+    return 1;
+}
+
+/**
+ * Wstawia cyfrę do pola i aktualizuje maski jednostek
+ */
+static inline void placeDigit(BitSolver *s, int idx, uint64_t bit) {
+    s->rows[s->rowOf[idx]] |= bit;
+    s->cols[s->colOf[idx]] |= bit;
+    s->boxes[s->boxOf[idx]] |= bit;
+    s->cells[idx] = (uint8_t)(CTZ(bit) + 1);
+}
+
+/**
+ * Usuwa cyfrę z pola i z masek jednostek
+ */
+static inline void removeDigit(BitSolver *s, int idx) {
+    uint64_t bit = (uint64_t)1 << (s->cells[idx] - 1);
+    s->rows[s->rowOf[idx]] &= ~bit;
+    s->cols[s->colOf[idx]] &= ~bit;
+    s->boxes[s->boxOf[idx]] &= ~bit;
+    s->cells[idx] = 0;
+}
+
+/**
+ * Sprawdza limit węzłów i czasu; zegar odczytywany jest tylko co TIME_CHECK_MASK + 1 węzłów
+ * @return 1 jeśli przeszukiwanie trzeba przerwać
+ */
+static inline int overBudget(BitSolver *s) {
+    s->nodes++;
+    if (s->nodeLimit > 0 && s->nodes > s->nodeLimit)
+        return 1;
+    return s->deadline > 0 && (s->nodes & TIME_CHECK_MASK) == 0 && nowSeconds() > s->deadline;
+}
+
+/**
+ * Iteracyjne przeszukiwanie z jawnym stosem: stack[d] to kandydaci pola empty[d],
+ * których jeszcze nie sprawdzono. Głębokość nie zależy od stosu wywołań.
+ * @param s - kontekst solvera
+ * @return 1 jeśli przeszukiwanie przerwano (znaleziono rozwiązanie, osiągnięto limit
+ *         rozwiązań, węzłów lub czasu), 0 jeśli przestrzeń została wyczerpana
+ */
+static int search(BitSolver *s) {
+    int depth = 0;
+    int entering = 1; // 1 - nowy węzeł na głębokości depth, 0 - powrót z głębszego poziomu
+    while (1) {
+        if (entering) {
+            entering = 0;
+            if (overBudget(s)) {
+                s->aborted = 1;
+                break;
+            }
+            uint64_t mask = 0;
+            if (depth == s->emptyCount) {
+                s->solutions++;
+                if (s->limit == 0)
+                    return 1; // rozwiązanie zostaje na planszy
+                if (s->solutions >= s->limit)
+                    break;
+            } else {
+                int bestPos;
+                if (chooseBranch(s, depth, &bestPos, &mask)) {
+                    int16_t idx = s->empty[bestPos];
+                    s->empty[bestPos] = s->empty[depth];
+                    s->empty[depth] = idx;
+                } else {
+                    mask = 0; // ślepa uliczka
+                }
+            }
+            s->stack[depth] = mask;
+        }
+
+        uint64_t mask = s->stack[depth];
+        if (mask == 0) {
+            // Poziom wyczerpany - wracamy i cofamy cyfrę z poziomu wyżej
+            if (depth == 0)
+                return 0;
+            depth--;
+            removeDigit(s, s->empty[depth]);
+            continue;
+        }
+        uint64_t bit = s->rng ? randomBit(mask, s->rng) : mask & -mask;
+        s->stack[depth] = mask & ~bit;
+        placeDigit(s, s->empty[depth], bit);
+        depth++;
+        entering = 1;
+    }
+    // Przerwanie - plansza wraca do stanu wejściowego
+    while (depth > 0) {
+        depth--;
+        removeDigit(s, s->empty[depth]);
+    }
+    return 1;
+}
+
+/**
+ * Rozwiązuje planszę dokładnie (backtracking na maskach bitowych z heurystyką MRV)
+ * @param board - plansza do rozwiązania; puste pola (0) zostaną wypełnione
+ * @param rng - generator do losowej kolejności kandydatów (NULL - kolejność stała)
+ * @return 1 jeśli znaleziono rozwiązanie, 0 jeśli plansza jest sprzeczna
+ */
+int solveExact(Board *board, Rng *rng) {
+    return solveExactBudget(board, rng, 0);
+}
+
+/**
+ * Rozwiązuje planszę dokładnie z limitem liczby odwiedzonych węzłów przeszukiwania
+ * @param board - plansza do rozwiązania; puste pola (0) zostaną wypełnione
+ * @param rng - generator do losowej kolejności kandydatów (NULL - kolejność stała)
+ * @param nodeLimit - maksymalna liczba węzłów (0 - bez limitu)
+ * @return 1 jeśli znaleziono rozwiązanie, 0 jeśli plansza jest sprzeczna, -1 po przekroczeniu limitu
+ */
+int solveExactBudget(Board *board, Rng *rng, long nodeLimit) {
+    return solveExactLimited(board, rng, nodeLimit, 0);
+}
+
+/**
+ * Rozwiązuje planszę dokładnie z limitem węzłów i czasu
+ * @param board - plansza do rozwiązania; puste pola (0) zostaną wypełnione
+ * @param rng - generator do losowej kolejności kandydatów (NULL - kolejność stała)
+ * @param nodeLimit - maksymalna liczba węzłów (0 - bez limitu)
+ * @param timeLimit - maksymalny czas w sekundach (0 - bez limitu)
+ * @return 1 jeśli znaleziono rozwiązanie, 0 jeśli plansza jest sprzeczna, -1 po przekroczeniu limitu
+ */
+int solveExactLimited(Board *board, Rng *rng, long nodeLimit, double timeLimit) {
+    BitSolver s;
+    if (!initSolver(&s, board, board->cells))
+        return 0;
+    s.rng = rng;
+    s.limit = 0;
+    s.nodeLimit = nodeLimit;
+    s.deadline = timeLimit > 0 ? nowSeconds() + timeLimit : 0;
+    int result = search(&s);
+    return s.aborted ? -1 : result;
+}
+
+/**
+ * Liczy rozwiązania planszy, przerywając po osiągnięciu limitu
+ * @param board - plansza z lukami (nie jest modyfikowana)
+ * @param limit - maksymalna liczba szukanych rozwiązań
+ * @return liczba znalezionych rozwiązań (co najwyżej limit)
+ */
+int countSolutions(const Board *board, int limit) {
+    if (limit <= 0)
+        return 0;
+
+    BitSolver s;
+    uint8_t cells[MAX_CELLS];
+    memcpy(cells, board->cells, board->size * board->size);
+
+    if (!initSolver(&s, board, cells))
+        return 0;
+    s.rng = NULL;
+    s.limit = limit;
+    search(&s);
+    return s.solutions;
+}
@@ -0,0 +1,52 @@
+/**
+ * Deklaracja dokładnego solvera Sudoku opartego na maskach bitowych.
+ * Dla każdego wiersza, kolumny i podkwadratu trzymana jest maska użytych cyfr,
+ * a przeszukiwanie wybiera pole z najmniejszą liczbą kandydatów (MRV),
+ * chyba że któraś cyfra ma w jednostce tylko jedno możliwe miejsce (ukryty singiel).
+ */
+#ifndef BITSOLVER_H
+#define BITSOLVER_H
+
+#include "board.h"
+#include "rng.h"
+
+/**
+ * Rozwiązuje planszę dokładnie (backtracking na maskach bitowych z heurystyką MRV)
+ * @param board - plansza do rozwiązania; puste pola (0) zostaną wypełnione
+ * @param rng - generator do losowej kolejności kandydatów przy generowaniu plansz;
+ *              NULL oznacza stałą kolejność 1..size
+ * @return 1 jeśli znaleziono rozwiązanie, 0 jeśli plansza jest sprzeczna
+ */
+int solveExact(Board *board, Rng *rng);
+
+/**
+ * Rozwiązuje planszę dokładnie z limitem liczby odwiedzonych węzłów przeszukiwania.
+ * Po przekroczeniu limitu plansza wraca do stanu wejściowego.
+ * @param board - plansza do rozwiązania; puste pola (0) zostaną wypełnione
+ * @param rng - generator do losowej kolejności kandydatów (NULL - kolejność stała)
+ * @param nodeLimit - maksymalna liczba węzłów (0 - bez limitu)
+ * @return 1 jeśli znaleziono rozwiązanie, 0 jeśli plansza jest sprzeczna, -1 po przekroczeniu limitu
+ */
+int solveExactBudget(Board *board, Rng *rng, long nodeLimit);
+
+/**
+ * Rozwiązuje planszę dokładnie z limitem węzłów i czasu. Przeszukiwanie jest iteracyjne
+ * (jawny stos w kontekście solvera, bez alokacji), więc głębokość nie obciąża stosu wywołań.
+ * Po przekroczeniu któregokolwiek limitu plansza wraca do stanu wejściowego.
+ * @param board - plansza do rozwiązania; puste pola (0) zostaną wypełnione
+ * @param rng - generator do losowej kolejności kandydatów (NULL - kolejność stała)
+ * @param nodeLimit - maksymalna liczba węzłów (0 - bez limitu)
+ * @param timeLimit - maksymalny czas w sekundach (0 - bez limitu)
+ * @return 1 jeśli znaleziono rozwiązanie, 0 jeśli plansza jest sprzeczna, -1 po przekroczeniu limitu
+ */
+int solveExactLimited(Board *board, Rng *rng, long nodeLimit, double timeLimit);
+
+/**
+ * Liczy rozwiązania planszy, przerywając po osiągnięciu limitu
+ * @param board - plansza z lukami (nie jest modyfikowana)
+ * @param limit - maksymalna liczba szukanych rozwiązań
+ * @return liczba znalezionych rozwiązań (co najwyżej limit)
+ */
+int countSolutions(const Board *board, int limit);
+
+#endif
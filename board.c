@@ -0,0 +1,83 @@
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+
+// Znaki kolejnych wartości pól w formacie tekstowym (indeks = wartość)
+static const char CELL_CHARS[] = ".123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!@#";
+
+/**
+ * Zwraca liczbę 64-bitowych słów bitsetu pól stałych
+ * @param size - rozmiar planszy
+ */
+static int fixedWords(int size) {
+    return (size * size + 63) / 64;
+}
+
+/**
+ * Zwraca rozmiar podkwadratu planszy size x size
+ * @param size - rozmiar planszy
+ * @return n dla size = n * n (MIN_BOX_SIZE <= n <= MAX_BOX_SIZE), 0 dla nieobsługiwanego rozmiaru
+ */
+int boardBoxSize(int size) {
+    for (int n = MIN_BOX_SIZE; n <= MAX_BOX_SIZE; n++)
+        if (n * n == size)
+            return n;
+    return 0;
+}
+
+/**
+ * Alokuje planszę wraz z bitsetem pól stałych w jednym bloku pamięci
+ * @param size - rozmiar planszy
+ * @return wskaźnik do zaalokowanej planszy
+ */
+Board *allocateBoard(int size) {
+    int words = fixedWords(size);
+    // struktura, bitset i komórki w jednym bloku - bitset zaraz za strukturą (wyrównanie 8 bajtów)
+    Board *board = calloc(1, sizeof(Board) + words * sizeof(uint64_t) + size * size);
+    if (board == NULL)
+        return NULL;
+    board->size = size;
+    board->box_size = boardBoxSize(size);
+    board->fixed = (uint64_t *)(board + 1);
+    board->cells = (uint8_t *)(board->fixed + words);
+    return board;
+}
+
+/**
+ * Zwalnia pamięć zajmowaną przez planszę
+ * @param board - plansza do zwolnienia
+ */
+void freeBoard(Board *board) {
+    free(board);
+}
+
+/**
+ * Kopiuje zawartość planszy (komórki i pola stałe) do drugiej planszy tego samego rozmiaru
+ * @param src - plansza źródłowa
+ * @param dest - plansza docelowa
+ */
+void copyBoard(const Board *src, Board *dest) {
+    memcpy(dest->cells, src->cells, src->size * src->size);
+    memcpy(dest->fixed, src->fixed, fixedWords(src->size) * sizeof(uint64_t));
+}
+
+/**
+ * Zamienia wartość pola na znak w formacie tekstowym
+ * @param val - wartość pola (0 - 64)
+ * @return znak odpowiadający wartości
+ */
+char cellToChar(int val) {
+    return CELL_CHARS[val];
+}
+
+/**
+ * Zamienia znak formatu tekstowego na wartość pola
+ * @param ch - znak
+ * @return wartość pola lub -1 dla nieznanego znaku
+ */
+int charToCell(char ch) {
+    if (ch == '0')
+        return 0;
+    const char *pos = ch != '\0' ? strchr(CELL_CHARS, ch) : NULL;
+    return pos ? (int)(pos - CELL_CHARS) : -1;
+}
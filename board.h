@@ -0,0 +1,96 @@
+/**
+ * Deklaracja zwartej reprezentacji planszy Sudoku.
+ * Wszystkie komórki leżą w jednym ciągłym bloku pamięci (po jednym bajcie na pole),
+ * a informacja o polach stałych jest przechowywana jako spakowany bitset.
+ */
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdint.h>
+
+#define MIN_BOX_SIZE 2 // najmniejszy podkwadrat (plansza 4x4)
+#define MAX_BOX_SIZE 6 // największy podkwadrat obsługiwany przez grę (plansza 36x36)
+#define MAX_SIZE (MAX_BOX_SIZE * MAX_BOX_SIZE) // maksymalny rozmiar planszy
+
+typedef struct {
+    int size;        // rozmiar planszy
+    int box_size;    // rozmiar pojedynczego podkwadratu
+    uint8_t *cells;  // komórki wierszami: cells[r * size + c], 0 oznacza puste pole
+    uint64_t *fixed; // bitset pól stałych: bit numer (r * size + c)
+} Board;
+
+/**
+ * Alokuje planszę wraz z bitsetem pól stałych w jednym bloku pamięci.
+ * Wszystkie pola są puste i niestałe.
+ * @param size - rozmiar planszy (kwadrat liczby od MIN_BOX_SIZE do MAX_BOX_SIZE, patrz boardBoxSize)
+ * @return wskaźnik do zaalokowanej planszy
+ */
+Board *allocateBoard(int size);
+
+/**
+ * Zwalnia pamięć zajmowaną przez planszę
+ * @param board - plansza do zwolnienia
+ */
+void freeBoard(Board *board);
+
+/**
+ * Kopiuje zawartość planszy (komórki i pola stałe) do drugiej planszy tego samego rozmiaru
+ * @param src - plansza źródłowa
+ * @param dest - plansza docelowa
+ */
+void copyBoard(const Board *src, Board *dest);
+
+/**
+ * Zwraca rozmiar podkwadratu planszy size x size
+ * @param size - rozmiar planszy
+ * @return n dla size = n * n (MIN_BOX_SIZE <= n <= MAX_BOX_SIZE), 0 dla nieobsługiwanego rozmiaru
+ */
+int boardBoxSize(int size);
+
+/**
+ * Zwraca wartość komórki (r, c)
+ */
+static inline int boardGet(const Board *board, int r, int c) {
+    return board->cells[r * board->size + c];
+}
+
+/**
+ * Ustawia wartość komórki (r, c)
+ */
+static inline void boardSet(Board *board, int r, int c, int val) {
+    board->cells[r * board->size + c] = (uint8_t)val;
+}
+
+/**
+ * Sprawdza czy pole o indeksie idx (r * size + c) jest stałe
+ */
+static inline int isFixedCell(const Board *board, int idx) {
+    return (int)((board->fixed[idx >> 6] >> (idx & 63)) & 1);
+}
+
+/**
+ * Oznacza pole o indeksie idx (r * size + c) jako stałe (fixed = 1) lub zmienne (fixed = 0)
+ */
+static inline void setFixedCell(Board *board, int idx, int fixed) {
+    if (fixed)
+        board->fixed[idx >> 6] |= (uint64_t)1 << (idx & 63);
+    else
+        board->fixed[idx >> 6] &= ~((uint64_t)1 << (idx & 63));
+}
+
+/**
+ * Zamienia wartość pola na znak w formacie tekstowym ('.' dla pustego pola,
+ * potem '1'-'9', 'A'-'Z', 'a'-'z' i "!@#" dla wartości do 64)
+ * @param val - wartość pola (0 - 64)
+ * @return znak odpowiadający wartości
+ */
+char cellToChar(int val);
+
+/**
+ * Zamienia znak formatu tekstowego na wartość pola ('.' i '0' oznaczają puste pole)
+ * @param ch - znak
+ * @return wartość pola lub -1 dla nieznanego znaku
+ */
+int charToCell(char ch);
+
+#endif
@@ -0,0 +1,322 @@
+#include <string.h>
+#include "energy.h"
+
+// Funkcje AVX2 korzystają z _mm_cvtsi64_si128 i _mm_cvtsi128_si64, dostępnych tylko w x86-64
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ENERGY_HAVE_AVX2 1
+#endif
+
+/**
+ * Liczy energię jednej jednostki na podstawie maski cyfr
+ * @param mask - maska cyfr, bit (v - 1) oznacza cyfrę v
+ * @param filled - liczba niepustych pól jednostki
+ */
+static inline int unitEnergy(uint64_t mask, int filled) {
+    return filled - __builtin_popcountll(mask);
+}
+
+/**
+ * Zwraca bit cyfry v (0 dla pustego pola)
+ */
+static inline uint64_t digitBit(int v) {
+    return (uint64_t)(v != 0) << ((v - 1) & 63);
+}
+
+/**
+ * Skalarna wersja liczenia energii (dowolny rozmiar do 64).
+ * Zawsze rozwijana w miejscu wywołania, aby wersje dla stałych rozmiarów miały stałe pętle.
+ * @param cells - komórki planszy
+ * @param size - rozmiar planszy
+ * @param boxSize - rozmiar podkwadratu
+ * @return wartość energii
+ */
+static inline __attribute__((always_inline)) int energyScalarSized(const uint8_t *cells, const int size,
+                                                                   const int boxSize) {
+    int energy = 0;
+    uint64_t colMask[64] = {0};
+    int colFilled[64] = {0};
+
+    // Wiersze i kolumny w jednym liniowym przejściu
+    for (int r = 0; r < size; r++) {
+        const uint8_t *row = cells + r * size;
+        uint64_t rowMask = 0;
+        int rowFilled = 0;
+        for (int c = 0; c < size; c++) {
+            uint64_t bit = digitBit(row[c]);
+            int filled = row[c] != 0;
+            rowMask |= bit;
+            rowFilled += filled;
+            colMask[c] |= bit;
+            colFilled[c] += filled;
+        }
+        energy += unitEnergy(rowMask, rowFilled);
+    }
+    for (int c = 0; c < size; c++)
+        energy += unitEnergy(colMask[c], colFilled[c]);
+
+    // Podkwadraty
+    for (int br = 0; br < size; br += boxSize) {
+        for (int bc = 0; bc < size; bc += boxSize) {
+            uint64_t mask = 0;
+            int filled = 0;
+            for (int i = 0; i < boxSize; i++) {
+                const uint8_t *row = cells + (br + i) * size + bc;
+                for (int j = 0; j < boxSize; j++) {
+                    mask |= digitBit(row[j]);
+                    filled += row[j] != 0;
+                }
+            }
+            energy += unitEnergy(mask, filled);
+        }
+    }
+    return energy;
+}
+
+/**
+ * Skalarna wersja liczenia energii z wariantami dla typowych rozmiarów
+ * @param cells - komórki planszy
+ * @param size - rozmiar planszy
+ * @return wartość energii
+ */
+static int energyScalar(const uint8_t *cells, int size) {
+    switch (size) {
+    case 4: return energyScalarSized(cells, 4, 2);
+    case 9: return energyScalarSized(cells, 9, 3);
+    case 16: return energyScalarSized(cells, 16, 4);
+    case 25: return energyScalarSized(cells, 25, 5);
+    case 36: return energyScalarSized(cells, 36, 6);
+    }
+    int boxSize = 1;
+    while (boxSize * boxSize < size)
+        boxSize++;
+    return energyScalarSized(cells, size, boxSize);
+}
+
+#ifdef ENERGY_HAVE_AVX2
+/**
+ * Wczytuje do 8 kolejnych bajtów planszy jako 8 liczb 32-bitowych.
+ * Bajty poza planszą oraz poza pierwszymi count pozycjami są zerowane (puste pola).
+ */
+__attribute__((target("avx2")))
+static inline __m256i load8(const uint8_t *cells, int offset, int total, int count) {
+    uint64_t raw = 0;
+    if (offset + 8 <= total)
+        memcpy(&raw, cells + offset, 8); // stały rozmiar - kompilator zamienia na jedno wczytanie
+    else
+        memcpy(&raw, cells + offset, total - offset); // koniec planszy - nie czytaj poza bufor
+    if (count < 8)
+        raw &= ((uint64_t)1 << (count * 8)) - 1;
+    return _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((long long)raw));
+}
+
+/**
+ * Zamienia wartości pól na bity (1 << v, puste pola dają bit 0) i zlicza niepuste pola
+ */
+__attribute__((target("avx2")))
+static inline __m256i cellBits(__m256i values, __m256i *filled) {
+    __m256i zero = _mm256_setzero_si256();
+    // cmpgt daje -1 dla niepustych pól, więc odejmowanie zwiększa licznik
+    *filled = _mm256_sub_epi32(*filled, _mm256_cmpgt_epi32(values, zero));
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), values);
+}
+
+/**
+ * Poziome OR 8 masek 32-bitowych
+ */
+__attribute__((target("avx2")))
+static inline uint32_t horizontalOr(__m256i v) {
+    __m128i x = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    x = _mm_or_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_or_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(x);
+}
+
+/**
+ * Pozioma suma 8 liczb 32-bitowych
+ */
+__attribute__((target("avx2")))
+static inline int horizontalSum(__m256i v) {
+    __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(x);
+}
+
+/**
+ * Wersja AVX2 liczenia energii (rozmiar do 31 - maski 1 << v mieszczą się w 32 bitach)
+ * @param cells - komórki planszy
+ * @param size - rozmiar planszy
+ * @return wartość energii
+ */
+__attribute__((target("avx2")))
+static int energyAvx2(const uint8_t *cells, int size) {
+    int boxSize = 1;
+    while (boxSize * boxSize < size)
+        boxSize++;
+    int total = size * size;
+    int energy = 0;
+
+    // Wiersze: każdy wiersz w porcjach po 8 pól
+    for (int r = 0; r < size; r++) {
+        __m256i mask = _mm256_setzero_si256(), filled = _mm256_setzero_si256();
+        for (int c = 0; c < size; c += 8) {
+            int count = size - c < 8 ? size - c : 8;
+            mask = _mm256_or_si256(mask, cellBits(load8(cells, r * size + c, total, count), &filled));
+        }
+        energy += unitEnergy(horizontalOr(mask) >> 1, horizontalSum(filled));
+    }
+
+    // Kolumny: 8 kolumn naraz, przejście po wierszach
+    for (int c = 0; c < size; c += 8) {
+        int count = size - c < 8 ? size - c : 8;
+        __m256i mask = _mm256_setzero_si256(), filled = _mm256_setzero_si256();
+        for (int r = 0; r < size; r++)
+            mask = _mm256_or_si256(mask, cellBits(load8(cells, r * size + c, total, count), &filled));
+        uint32_t masks[8];
+        int fills[8];
+        _mm256_storeu_si256((__m256i *)masks, mask);
+        _mm256_storeu_si256((__m256i *)fills, filled);
+        for (int k = 0; k < count; k++)
+            energy += unitEnergy(masks[k] >> 1, fills[k]);
+    }
+
+    // Podkwadraty: wiersz podkwadratu (boxSize <= 5) w jednej porcji
+    for (int br = 0; br < size; br += boxSize) {
+        for (int bc = 0; bc < size; bc += boxSize) {
+            __m256i mask = _mm256_setzero_si256(), filled = _mm256_setzero_si256();
+            for (int i = 0; i < boxSize; i++)
+                mask = _mm256_or_si256(mask, cellBits(load8(cells, (br + i) * size + bc, total, boxSize), &filled));
+            energy += unitEnergy(horizontalOr(mask) >> 1, horizontalSum(filled));
+        }
+    }
+    return energy;
+}
+
+/**
+ * Wczytuje do 4 kolejnych bajtów planszy jako 4 liczby 64-bitowe (zerując bajty poza zakresem)
+ */
+__attribute__((target("avx2")))
+static inline __m256i load4(const uint8_t *cells, int offset, int total, int count) {
+    uint32_t raw = 0;
+    if (offset + 4 <= total)
+        memcpy(&raw, cells + offset, 4);
+    else
+        memcpy(&raw, cells + offset, total - offset);
+    if (count < 4)
+        raw &= ((uint32_t)1 << (count * 8)) - 1;
+    return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)raw));
+}
+
+/**
+ * Zamienia wartości pól na bity 1 << (v - 1) w liczbach 64-bitowych i zlicza niepuste pola.
+ * Dla pustego pola przesunięcie o -1 jest poza zakresem, więc vpsllvq daje 0.
+ */
+__attribute__((target("avx2")))
+static inline __m256i cellBitsWide(__m256i values, __m256i *filled) {
+    __m256i one = _mm256_set1_epi64x(1);
+    *filled = _mm256_sub_epi64(*filled, _mm256_cmpgt_epi64(values, _mm256_setzero_si256()));
+    return _mm256_sllv_epi64(one, _mm256_sub_epi64(values, one));
+}
+
+/**
+ * Poziome OR 4 masek 64-bitowych
+ */
+__attribute__((target("avx2")))
+static inline uint64_t horizontalOrWide(__m256i v) {
+    __m128i x = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    x = _mm_or_si128(x, _mm_unpackhi_epi64(x, x));
+    return (uint64_t)_mm_cvtsi128_si64(x);
+}
+
+/**
+ * Pozioma suma 4 liczb 64-bitowych
+ */
+__attribute__((target("avx2")))
+static inline int horizontalSumWide(__m256i v) {
+    __m128i x = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    x = _mm_add_epi64(x, _mm_unpackhi_epi64(x, x));
+    return (int)_mm_cvtsi128_si64(x);
+}
+
+/**
+ * Wersja AVX2 dla dużych plansz (rozmiar od 32 do 64) - maski 64-bitowe, 4 pola na raz
+ * @param cells - komórki planszy
+ * @param size - rozmiar planszy
+ * @return wartość energii
+ */
+__attribute__((target("avx2")))
+static int energyAvx2Wide(const uint8_t *cells, int size) {
+    int boxSize = 1;
+    while (boxSize * boxSize < size)
+        boxSize++;
+    int total = size * size;
+    int energy = 0;
+
+    // Wiersze w porcjach po 4 pola
+    for (int r = 0; r < size; r++) {
+        __m256i mask = _mm256_setzero_si256(), filled = _mm256_setzero_si256();
+        for (int c = 0; c < size; c += 4) {
+            int count = size - c < 4 ? size - c : 4;
+            mask = _mm256_or_si256(mask, cellBitsWide(load4(cells, r * size + c, total, count), &filled));
+        }
+        energy += unitEnergy(horizontalOrWide(mask), horizontalSumWide(filled));
+    }
+
+    // Kolumny: 4 kolumny naraz
+    for (int c = 0; c < size; c += 4) {
+        int count = size - c < 4 ? size - c : 4;
+        __m256i mask = _mm256_setzero_si256(), filled = _mm256_setzero_si256();
+        for (int r = 0; r < size; r++)
+            mask = _mm256_or_si256(mask, cellBitsWide(load4(cells, r * size + c, total, count), &filled));
+        uint64_t masks[4];
+        int64_t fills[4];
+        _mm256_storeu_si256((__m256i *)masks, mask);
+        _mm256_storeu_si256((__m256i *)fills, filled);
+        for (int k = 0; k < count; k++)
+            energy += unitEnergy(masks[k], (int)fills[k]);
+    }
+
+    // Podkwadraty: wiersz podkwadratu (boxSize <= 8) w jednej lub dwóch porcjach
+    for (int br = 0; br < size; br += boxSize) {
+        for (int bc = 0; bc < size; bc += boxSize) {
+            __m256i mask = _mm256_setzero_si256(), filled = _mm256_setzero_si256();
+            for (int i = 0; i < boxSize; i++) {
+                for (int j = 0; j < boxSize; j += 4) {
+                    int count = boxSize - j < 4 ? boxSize - j : 4;
+                    int offset = (br + i) * size + bc + j;
+                    mask = _mm256_or_si256(mask, cellBitsWide(load4(cells, offset, total, count), &filled));
+                }
+            }
+            energy += unitEnergy(horizontalOrWide(mask), horizontalSumWide(filled));
+        }
+    }
+    return energy;
+}
+#endif
+
+/**
+ * Liczy energię planszy - liczbę powtórzeń cyfr w wierszach, kolumnach i podkwadratach
+ * @param cells - komórki planszy wierszami (0 - puste pole)
+ * @param size - rozmiar planszy
+ * @return wartość energii
+ */
+int boardEnergy(const uint8_t *cells, int size) {
+#ifdef ENERGY_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        return size < 32 ? energyAvx2(cells, size) : energyAvx2Wide(cells, size);
+#endif
+    return energyScalar(cells, size);
+}
+
+/**
+ * Sprawdza czy plansza jest poprawnym, kompletnym rozwiązaniem
+ * @param board - plansza
+ * @return 1 jeśli wszystkie pola są wypełnione i nie ma żadnych powtórzeń, 0 w przeciwnym wypadku
+ */
+int isValidSolution(const Board *board) {
+    int total = board->size * board->size;
+    if (memchr(board->cells, 0, total) != NULL)
+        return 0;
+    return boardEnergy(board->cells, board->size) == 0;
+}
@@ -0,0 +1,29 @@
+/**
+ * Deklaracja szybkiego liczenia energii i sprawdzania poprawności całej planszy.
+ * Każdy wiersz, kolumna i podkwadrat zamieniany jest na maskę bitową cyfr; liczba
+ * powtórzeń w jednostce to liczba niepustych pól minus liczba ustawionych bitów maski.
+ * Na procesorach z AVX2 maski liczone są wektorowo (8 pól naraz), w pozostałych
+ * przypadkach używana jest wersja skalarna.
+ */
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdint.h>
+#include "board.h"
+
+/**
+ * Liczy energię planszy - liczbę powtórzeń cyfr w wierszach, kolumnach i podkwadratach
+ * @param cells - komórki planszy wierszami (0 - puste pole)
+ * @param size - rozmiar planszy
+ * @return wartość energii
+ */
+int boardEnergy(const uint8_t *cells, int size);
+
+/**
+ * Sprawdza czy plansza jest poprawnym, kompletnym rozwiązaniem
+ * @param board - plansza
+ * @return 1 jeśli wszystkie pola są wypełnione i nie ma żadnych powtórzeń, 0 w przeciwnym wypadku
+ */
+int isValidSolution(const Board *board);
+
+#endif
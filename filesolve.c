@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "filesolve.h"
+#include "solvercontext.h"
+#include "presolve.h"
+#include "SA_algorithm.h"
+
+#define FILESOLVE_CHUNK_SIZE (64 * 1024) // docelowa liczba bajtów wejścia na fragment
+#define FILESOLVE_CHUNKS_PER_THREAD 4 // ile fragmentów na wątek może czekać na zapis
+#define FILESOLVE_OUTPUT_BUFFER (1024 * 1024) // bufor pliku wynikowego
+#define FILESOLVE_SA_ITERATIONS 2000000 // limit iteracji wyżarzania na jedną zagadkę
+#define FILESOLVE_PROGRESS_INTERVAL 0.5 // odstęp między raportami postępu w sekundach
+
+typedef struct {
+    char *data; // gotowe linie wyjścia fragmentu
+    size_t len; // długość danych
+    long solved; // liczba rozwiązanych zagadek
+    long failed; // liczba zagadek z odpowiedzią FAIL, TIMEOUT lub ERR
+    int ready; // 1 gdy fragment czeka na zapis
+} ChunkResult;
+
+typedef struct {
+    const char *input; // zmapowany plik wejściowy
+    size_t *bounds; // granice fragmentów: fragment i to [bounds[i], bounds[i + 1])
+    int chunkCount; // liczba fragmentów
+    int window; // maksymalna liczba fragmentów wyprzedzających zapis
+    int method; // metoda rozwiązywania
+    uint64_t seed; // ziarno bazowe wyżarzania
+    atomic_int next; // numer następnego fragmentu do pobrania przez wątek
+    ChunkResult *results; // wyniki fragmentów
+    int written; // liczba fragmentów zapisanych do pliku
+    pthread_mutex_t mutex; // chroni results i written
+    pthread_cond_t chunkReady; // sygnalizowane po ukończeniu fragmentu
+    pthread_cond_t chunkWritten; // sygnalizowane po zapisaniu fragmentu
+} FileJob;
+
+typedef struct {
+    char *data; // dane
+    size_t len; // długość danych
+    size_t capacity; // pojemność bufora
+} OutputBuffer;
+
+typedef struct {
+    Board *board; // kopia zagadki po propagacji ograniczeń
+    size_t pos; // miejsce linii wyniku w buforze wyjściowym fragmentu
+    uint64_t stream; // numer strumienia generatora zagadki
+    int solved; // wynik wyżarzania partiami
+} PendingPuzzle;
+
+/**
+ * Zapewnia miejsce na extra kolejnych bajtów w buforze wyjściowym
+ * @param out - bufor
+ * @param extra - liczba potrzebnych bajtów
+ */
+static void reserveOutput(OutputBuffer *out, size_t extra) {
+    if (out->len + extra <= out->capacity)
+        return;
+    while (out->len + extra > out->capacity)
+        out->capacity = out->capacity ? out->capacity * 2 : 4096;
+    out->data = realloc(out->data, out->capacity);
+}
+
+/**
+ * Dopisuje linię "<status> <treść>\n" do bufora wyjściowego
+ * @param out - bufor
+ * @param status - status odpowiedzi
+ * @param text - treść
+ */
+static void appendLine(OutputBuffer *out, const char *status, const char *text) {
+    size_t statusLen = strlen(status), textLen = strlen(text);
+    reserveOutput(out, statusLen + textLen + 2);
+    memcpy(out->data + out->len, status, statusLen);
+    out->data[out->len + statusLen] = ' ';
+    memcpy(out->data + out->len + statusLen + 1, text, textLen);
+    out->len += statusLen + textLen + 2;
+    out->data[out->len - 1] = '\n';
+}
+
+/**
+ * Dopisuje linię "<status> <plansza>\n" do bufora wyjściowego
+ * @param out - bufor
+ * @param status - status odpowiedzi
+ * @param board - plansza
+ */
+static void appendBoardLine(OutputBuffer *out, const char *status, const Board *board) {
+    int n = board->size * board->size;
+    size_t statusLen = strlen(status);
+    reserveOutput(out, statusLen + n + 2);
+    char *dest = out->data + out->len;
+    memcpy(dest, status, statusLen);
+    dest += statusLen;
+    *dest++ = ' ';
+    for (int idx = 0; idx < n; idx++)
+        dest[idx] = cellToChar(board->cells[idx]);
+    dest[n] = '\n';
+    out->len += statusLen + n + 2;
+}
+
+/**
+ * Rozwiązuje zagadki odłożone w trybie SOLVE_METHOD_BATCH (po jednej partii na rozmiar planszy)
+ * i wstawia ich linie w zapamiętane miejsca bufora wyjściowego
+ * @param job - wspólne dane zadania
+ * @param out - bufor wyjściowy fragmentu (bez linii odłożonych zagadek)
+ * @param pending - odłożone zagadki w kolejności wejścia
+ * @param count - liczba odłożonych zagadek
+ * @param result - wynik fragmentu (liczniki)
+ */
+static void solvePending(FileJob *job, OutputBuffer *out, PendingPuzzle *pending, int count, ChunkResult *result) {
+    Board **boards = malloc(count * sizeof(Board *));
+    uint64_t *streams = malloc(count * sizeof(uint64_t));
+    int *solved = malloc(count * sizeof(int));
+    int *index = malloc(count * sizeof(int));
+    for (int box = MIN_BOX_SIZE; box <= MAX_BOX_SIZE; box++) {
+        int group = 0;
+        for (int i = 0; i < count; i++) {
+            if (pending[i].board->box_size != box)
+                continue;
+            boards[group] = pending[i].board;
+            streams[group] = pending[i].stream;
+            index[group++] = i;
+        }
+        if (group == 0)
+            continue;
+        solve_sudoku_sa_batch(boards, group, FILESOLVE_SA_ITERATIONS, job->seed, streams, solved);
+        for (int g = 0; g < group; g++)
+            pending[index[g]].solved = solved[g];
+    }
+
+    OutputBuffer merged = {NULL, 0, 0};
+    reserveOutput(&merged, out->len + (size_t)count * (pending[0].board->size * pending[0].board->size + 6));
+    size_t from = 0;
+    for (int i = 0; i < count; i++) {
+        size_t len = pending[i].pos - from;
+        reserveOutput(&merged, len);
+        memcpy(merged.data + merged.len, out->data + from, len);
+        merged.len += len;
+        from = pending[i].pos;
+        appendBoardLine(&merged, pending[i].solved ? "OK" : "FAIL", pending[i].board);
+        if (pending[i].solved)
+            result->solved++;
+        else
+            result->failed++;
+        freeBoard(pending[i].board);
+    }
+    reserveOutput(&merged, out->len - from);
+    memcpy(merged.data + merged.len, out->data + from, out->len - from);
+    merged.len += out->len - from;
+    free(out->data);
+    *out = merged;
+    free(boards);
+    free(streams);
+    free(solved);
+    free(index);
+}
+
+/**
+ * Rozwiązuje wszystkie linie jednego fragmentu wejścia
+ * @param job - wspólne dane zadania
+ * @param ctx - kontekst solvera wątku
+ * @param chunk - numer fragmentu
+ * @param result - miejsce na wynik fragmentu
+ */
+static void solveChunk(FileJob *job, SolverContext *ctx, int chunk, ChunkResult *result) {
+    const char *pos = job->input + job->bounds[chunk];
+    const char *end = job->input + job->bounds[chunk + 1];
+    OutputBuffer out = {NULL, 0, 0};
+    reserveOutput(&out, end - pos + 64); // wyjście jest zwykle nie dłuższe niż wejście
+    PendingPuzzle *pending = NULL;
+    int pendingCount = 0, pendingCapacity = 0;
+    result->solved = 0;
+    result->failed = 0;
+
+    while (pos < end) {
+        const char *lineEnd = memchr(pos, '\n', end - pos);
+        if (lineEnd == NULL)
+            lineEnd = end; // ostatnia linia pliku bez znaku nowej linii
+        const char *word = pos;
+        while (word < lineEnd && (*word == ' ' || *word == '\t' || *word == '\r'))
+            word++;
+        const char *wordEnd = word;
+        while (wordEnd < lineEnd && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r')
+            wordEnd++;
+        uint64_t stream = (uint64_t)(pos - job->input);
+        pos = lineEnd + 1;
+
+        if (word == wordEnd) {
+            reserveOutput(&out, 1);
+            out.data[out.len++] = '\n';
+            continue;
+        }
+        const char *error = NULL;
+        Board *board = parsePuzzle(ctx, word, wordEnd - word, &error);
+        if (board == NULL) {
+            appendLine(&out, "ERR", error);
+            result->failed++;
+            continue;
+        }
+        if (job->method == SOLVE_METHOD_BATCH && presolveBoard(board) >= 0 &&
+            memchr(board->cells, 0, board->size * board->size) != NULL) {
+            // Zagadka czeka na resztę fragmentu; jej linia zostanie wstawiona w miejscu out.len
+            if (pendingCount == pendingCapacity) {
+                pendingCapacity = pendingCapacity ? pendingCapacity * 2 : 64;
+                pending = realloc(pending, pendingCapacity * sizeof(PendingPuzzle));
+            }
+            pending[pendingCount].board = allocateBoard(board->size);
+            copyBoard(board, pending[pendingCount].board);
+            pending[pendingCount].pos = out.len;
+            pending[pendingCount].stream = stream;
+            pendingCount++;
+            continue;
+        }
+        int status = solvePuzzle(ctx, board, job->method, FILESOLVE_SA_ITERATIONS, job->seed, stream, NULL);
+        if (status == SOLVE_CONTRADICTION) {
+            appendLine(&out, "ERR", "plansza sprzeczna");
+            result->failed++;
+        } else {
+            appendBoardLine(&out, status == SOLVE_OK ? "OK" : status == SOLVE_TIMEOUT ? "TIMEOUT" : "FAIL", board);
+            if (status == SOLVE_OK)
+                result->solved++;
+            else
+                result->failed++;
+        }
+    }
+    if (pendingCount > 0)
+        solvePending(job, &out, pending, pendingCount, result);
+    free(pending);
+    result->data = out.data;
+    result->len = out.len;
+}
+
+/**
+ * Funkcja wątku roboczego: pobiera kolejne fragmenty, nie wyprzedzając zapisu
+ * o więcej niż job->window fragmentów
+ * @param arg - wskaźnik na FileJob
+ */
+static void *fileWorker(void *arg) {
+    FileJob *job = arg;
+    SolverContext *ctx = createSolverContext();
+
+    while (1) {
+        int chunk = atomic_fetch_add(&job->next, 1);
+        if (chunk >= job->chunkCount)
+            break;
+        pthread_mutex_lock(&job->mutex);
+        while (chunk >= job->written + job->window)
+            pthread_cond_wait(&job->chunkWritten, &job->mutex);
+        pthread_mutex_unlock(&job->mutex);
+
+        ChunkResult result;
+        solveChunk(job, ctx, chunk, &result);
+
+        pthread_mutex_lock(&job->mutex);
+        job->results[chunk] = result;
+        job->results[chunk].ready = 1;
+        pthread_cond_broadcast(&job->chunkReady);
+        pthread_mutex_unlock(&job->mutex);
+    }
+    freeSolverContext(ctx);
+    return NULL;
+}
+
+/**
+ * Dzieli wejście na fragmenty około FILESOLVE_CHUNK_SIZE bajtów kończące się na granicy linii
+ * @param data - zmapowany plik
+ * @param size - rozmiar pliku
+ * @param count - miejsce na liczbę fragmentów
+ * @return tablica count + 1 granic fragmentów
+ */
+static size_t *splitChunks(const char *data, size_t size, int *count) {
+    size_t capacity = size / FILESOLVE_CHUNK_SIZE + 2;
+    size_t *bounds = malloc(capacity * sizeof(size_t));
+    size_t pos = 0;
+    int n = 0;
+    bounds[0] = 0;
+    while (pos < size) {
+        size_t end = pos + FILESOLVE_CHUNK_SIZE;
+        if (end >= size) {
+            end = size;
+        } else {
+            const char *newline = memchr(data + end, '\n', size - end);
+            end = newline ? (size_t)(newline - data) + 1 : size;
+        }
+        bounds[++n] = end;
+        pos = end;
+    }
+    *count = n;
+    return bounds;
+}
+
+/**
+ * Zwraca czas w sekundach od chwili start
+ */
+static double elapsedSince(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * Rozwiązuje wszystkie zagadki z pliku wejściowego i zapisuje wyniki do pliku wyjściowego
+ * @param input - ścieżka pliku z zagadkami
+ * @param output - ścieżka pliku wynikowego
+ * @param threads - liczba wątków roboczych
+ * @param method - SOLVE_METHOD_EXACT, SOLVE_METHOD_SA, SOLVE_METHOD_HYBRID lub SOLVE_METHOD_BATCH
+ * @param seed - ziarno bazowe wyżarzania
+ * @return 0 w przypadku powodzenia, 1 w przypadku błędu
+ */
+int runFileSolve(const char *input, const char *output, int threads, int method, uint64_t seed) {
+    if (threads < 1) threads = 1;
+
+    int fd = open(input, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(input);
+        if (fd >= 0)
+            close(fd);
+        return 1;
+    }
+    size_t size = (size_t)st.st_size;
+    char *data = NULL;
+    if (size > 0) {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror(input);
+            close(fd);
+            return 1;
+        }
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+    close(fd); // mapowanie pozostaje ważne po zamknięciu deskryptora
+
+    FILE *out = fopen(output, "w");
+    if (out == NULL) {
+        perror(output);
+        if (data != NULL)
+            munmap(data, size);
+        return 1;
+    }
+    char *outBuffer = malloc(FILESOLVE_OUTPUT_BUFFER);
+    setvbuf(out, outBuffer, _IOFBF, FILESOLVE_OUTPUT_BUFFER);
+
+    FileJob job;
+    job.input = data;
+    job.bounds = splitChunks(data, size, &job.chunkCount);
+    job.window = threads * FILESOLVE_CHUNKS_PER_THREAD;
+    job.method = method;
+    job.seed = seed;
+    atomic_init(&job.next, 0);
+    job.results = calloc(job.chunkCount > 0 ? job.chunkCount : 1, sizeof(ChunkResult));
+    job.written = 0;
+    pthread_mutex_init(&job.mutex, NULL);
+    pthread_cond_init(&job.chunkReady, NULL);
+    pthread_cond_init(&job.chunkWritten, NULL);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t workers[threads];
+    for (int t = 0; t < threads; t++)
+        pthread_create(&workers[t], NULL, fileWorker, &job);
+
+    // Wątek główny zapisuje fragmenty w kolejności wejścia, gdy tylko są gotowe
+    long solved = 0, failed = 0;
+    double lastReport = 0;
+    for (int chunk = 0; chunk < job.chunkCount; chunk++) {
+        pthread_mutex_lock(&job.mutex);
+        while (!job.results[chunk].ready)
+            pthread_cond_wait(&job.chunkReady, &job.mutex);
+        ChunkResult result = job.results[chunk];
+        pthread_mutex_unlock(&job.mutex);
+
+        fwrite(result.data, 1, result.len, out);
+        free(result.data);
+        solved += result.solved;
+        failed += result.failed;
+
+        pthread_mutex_lock(&job.mutex);
+        job.written = chunk + 1;
+        pthread_cond_broadcast(&job.chunkWritten);
+        pthread_mutex_unlock(&job.mutex);
+
+        double seconds = elapsedSince(&start);
+        if (seconds - lastReport >= FILESOLVE_PROGRESS_INTERVAL) {
+            lastReport = seconds;
+            fprintf(stderr, "\rPostęp: %5.1f%% (%ld plansz, %.1f plansz/s)",
+                    100.0 * job.bounds[chunk + 1] / size, solved + failed, (solved + failed) / seconds);
+        }
+    }
+    for (int t = 0; t < threads; t++)
+        pthread_join(workers[t], NULL);
+    if (lastReport > 0)
+        fprintf(stderr, "\n");
+
+    double seconds = elapsedSince(&start);
+    int writeFailed = fclose(out) != 0;
+    free(outBuffer);
+    pthread_cond_destroy(&job.chunkWritten);
+    pthread_cond_destroy(&job.chunkReady);
+    pthread_mutex_destroy(&job.mutex);
+    free(job.results);
+    free(job.bounds);
+    if (data != NULL)
+        munmap(data, size);
+    if (writeFailed) {
+        perror(output);
+        return 1;
+    }
+
+    long total = solved + failed;
+    printf("Rozwiązano %ld z %ld plansz w %.3f s (%.1f plansz/s, %.1f MB/s, wątki: %d)\n",
+           solved, total, seconds, seconds > 0 ? total / seconds : 0.0,
+           seconds > 0 ? size / seconds / 1e6 : 0.0, threads);
+    return 0;
+}
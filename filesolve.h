@@ -0,0 +1,33 @@
+/**
+ * Deklaracja trybu rozwiązywania pliku zagadek. Plik wejściowy jest mapowany
+ * do pamięci i dzielony na fragmenty po pełnych liniach, które wątki robocze
+ * rozwiązują równolegle; wyniki trafiają do pliku w kolejności wejścia.
+ *
+ * Z każdej linii wejścia brane jest pierwsze słowo - zagadka w formacie cellToChar
+ * (pliki z trybu wsadowego "<zagadka> <rozwiązanie>" można podać bez zmian).
+ * Każdej linii wejścia odpowiada jedna linia wyjścia:
+ *   OK <rozwiązanie>
+ *   FAIL <najlepsza plansza>   (wyżarzanie nie osiągnęło energii 0)
+ *   TIMEOUT <plansza>   (solver bitowy przekroczył limit czasu; plansza wejściowa lub najlepsza z wyżarzania)
+ *   ERR <opis błędu>
+ * Puste linie są przepisywane jako puste.
+ */
+#ifndef FILESOLVE_H
+#define FILESOLVE_H
+
+#include <stdint.h>
+
+/**
+ * Rozwiązuje wszystkie zagadki z pliku wejściowego i zapisuje wyniki do pliku wyjściowego.
+ * W trakcie pracy wypisuje postęp na stderr, a na koniec przepustowość.
+ * @param input - ścieżka pliku z zagadkami
+ * @param output - ścieżka pliku wynikowego
+ * @param threads - liczba wątków roboczych
+ * @param method - SOLVE_METHOD_EXACT, SOLVE_METHOD_SA, SOLVE_METHOD_HYBRID lub SOLVE_METHOD_BATCH
+ *                 (przy SOLVE_METHOD_BATCH zagadki fragmentu wymagające wyżarzania są rozwiązywane razem)
+ * @param seed - ziarno bazowe wyżarzania; strumień zagadki to przesunięcie jej linii w pliku
+ * @return 0 w przypadku powodzenia, 1 w przypadku błędu
+ */
+int runFileSolve(const char *input, const char *output, int threads, int method, uint64_t seed);
+
+#endif
@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include <string.h>
+#include "gamestate.h"
+#include "bitsolver.h"
+
+#define GAME_CELL_BYTES 24 // najdłuższy zapis pola w klatce (kolory + liczba + odstęp)
+#define GAME_HINT_SECONDS 0.5 // limit solvera na każde rozwiązywanie przy podpowiedzi (z wpisami gracza i same pola stałe)
+
+/**
+ * Wyznacza wiersz, kolumnę i podkwadrat pola
+ */
+static void unitsOf(const Board *board, int idx, int unit[3]) {
+    int r = idx / board->size, c = idx % board->size;
+    unit[0] = r;
+    unit[1] = c;
+    unit[2] = (r / board->box_size) * board->box_size + c / board->box_size;
+}
+
+/**
+ * Dodaje (delta = 1) lub usuwa (delta = -1) cyfrę z liczników jednostek pola
+ */
+static void countDigit(GameState *game, int idx, int val, int delta) {
+    if (val == 0)
+        return;
+    int unit[3];
+    unitsOf(game->board, idx, unit);
+    uint64_t bit = (uint64_t)1 << (val - 1);
+    for (int k = 0; k < 3; k++) {
+        uint8_t *count = &game->counts[k][unit[k]][val];
+        if (delta > 0) {
+            if (*count >= 1)
+                game->duplicates++;
+            (*count)++;
+        } else {
+            (*count)--;
+            if (*count >= 1)
+                game->duplicates--;
+        }
+        game->used[k][unit[k]] = *count >= 1 ? game->used[k][unit[k]] | bit : game->used[k][unit[k]] & ~bit;
+        game->clashing[k][unit[k]] = *count >= 2 ? game->clashing[k][unit[k]] | bit : game->clashing[k][unit[k]] & ~bit;
+    }
+}
+
+/**
+ * Zmienia wartość pola i aktualizuje liczniki (bez dziennika)
+ */
+static void applyValue(GameState *game, int idx, int val) {
+    int old = game->board->cells[idx];
+    countDigit(game, idx, old, -1);
+    countDigit(game, idx, val, 1);
+    game->emptyCount += (val == 0) - (old == 0);
+    game->board->cells[idx] = (uint8_t)val;
+    game->lastIdx = idx;
+}
+
+/**
+ * Tworzy stan gry dla planszy i przelicza liczniki jednostek
+ * @param board - plansza gry
+ * @return stan gry
+ */
+GameState *createGameState(Board *board) {
+    GameState *game = calloc(1, sizeof(GameState));
+    int size = board->size;
+    game->board = board;
+    game->scratch = allocateBoard(size);
+    game->lastIdx = -1;
+    for (int idx = 0; idx < size * size; idx++) {
+        if (board->cells[idx] == 0)
+            game->emptyCount++;
+        else
+            countDigit(game, idx, board->cells[idx], 1);
+    }
+    game->journalCapacity = 64;
+    game->journal = malloc(game->journalCapacity * sizeof(GameMove));
+    // nagłówek i numery wierszy plus pola - cała klatka mieści się w jednym buforze
+    game->frameCapacity = (size_t)(size + 1) * (size * GAME_CELL_BYTES + 32);
+    game->frame = malloc(game->frameCapacity);
+    return game;
+}
+
+/**
+ * Zwalnia stan gry (bez planszy)
+ * @param game - stan gry
+ */
+void freeGameState(GameState *game) {
+    freeBoard(game->scratch);
+    free(game->journal);
+    free(game->frame);
+    free(game);
+}
+
+/**
+ * Wpisuje wartość w pole i zapisuje ruch w dzienniku
+ * @param game - stan gry
+ * @param idx - indeks pola
+ * @param val - wartość 0 .. size
+ * @return GAME_MOVE_OK, GAME_MOVE_CONFLICT, GAME_MOVE_FIXED lub GAME_MOVE_UNCHANGED
+ */
+int gameSetCell(GameState *game, int idx, int val) {
+    if (isFixedCell(game->board, idx))
+        return GAME_MOVE_FIXED;
+    int old = game->board->cells[idx];
+    if (old == val)
+        return GAME_MOVE_UNCHANGED;
+
+    if (game->journalPos == game->journalCapacity) {
+        game->journalCapacity *= 2;
+        game->journal = realloc(game->journal, game->journalCapacity * sizeof(GameMove));
+    }
+    GameMove *move = &game->journal[game->journalPos++];
+    move->idx = (int16_t)idx;
+    move->before = (uint8_t)old;
+    move->after = (uint8_t)val;
+    game->journalLen = game->journalPos; // nowy ruch unieważnia ruchy do ponowienia
+
+    applyValue(game, idx, val);
+    return val != 0 && gameCellConflicted(game, idx) ? GAME_MOVE_CONFLICT : GAME_MOVE_OK;
+}
+
+/**
+ * Sprawdza, czy cyfra powtórzyłaby się w jednostkach pola
+ * @param game - stan gry
+ * @param idx - indeks pola
+ * @param val - cyfra 1 .. size
+ * @return 1 jeśli cyfra koliduje z innym polem
+ */
+int gameWouldConflict(const GameState *game, int idx, int val) {
+    if (game->board->cells[idx] == val)
+        return gameCellConflicted(game, idx);
+    int unit[3];
+    unitsOf(game->board, idx, unit);
+    uint64_t bit = (uint64_t)1 << (val - 1);
+    return ((game->used[0][unit[0]] | game->used[1][unit[1]] | game->used[2][unit[2]]) & bit) != 0;
+}
+
+/**
+ * Sprawdza, czy wartość pola powtarza się w którejś z jego jednostek
+ * @param game - stan gry
+ * @param idx - indeks pola
+ * @return 1 dla pola w konflikcie
+ */
+int gameCellConflicted(const GameState *game, int idx) {
+    int val = game->board->cells[idx];
+    if (val == 0)
+        return 0;
+    int unit[3];
+    unitsOf(game->board, idx, unit);
+    uint64_t bit = (uint64_t)1 << (val - 1);
+    return ((game->clashing[0][unit[0]] | game->clashing[1][unit[1]] | game->clashing[2][unit[2]]) & bit) != 0;
+}
+
+/**
+ * Sprawdza, czy plansza jest pełna i bez konfliktów
+ * @param game - stan gry
+ * @return 1 jeśli zagadka jest rozwiązana
+ */
+int gameIsSolved(const GameState *game) {
+    return game->emptyCount == 0 && game->duplicates == 0;
+}
+
+/**
+ * Cofa ostatni ruch
+ * @param game - stan gry
+ * @return indeks zmienionego pola lub -1
+ */
+int gameUndo(GameState *game) {
+    if (game->journalPos == 0)
+        return -1;
+    const GameMove *move = &game->journal[--game->journalPos];
+    applyValue(game, move->idx, move->before);
+    return move->idx;
+}
+
+/**
+ * Ponawia ostatnio cofnięty ruch
+ * @param game - stan gry
+ * @return indeks zmienionego pola lub -1
+ */
+int gameRedo(GameState *game) {
+    if (game->journalPos == game->journalLen)
+        return -1;
+    const GameMove *move = &game->journal[game->journalPos++];
+    applyValue(game, move->idx, move->after);
+    return move->idx;
+}
+
+/**
+ * Podpowiedź oparta na solverze bitowym
+ * @param game - stan gry
+ * @param idx - miejsce na indeks pola
+ * @param val - miejsce na wartość
+ * @return GAME_HINT_PLACED, GAME_HINT_WRONG, GAME_HINT_NONE lub GAME_HINT_TIMEOUT
+ */
+int gameHint(GameState *game, int *idx, int *val) {
+    Board *board = game->board;
+    Board *scratch = game->scratch;
+    int size = board->size;
+    int n = size * size;
+    if (game->emptyCount == 0 && game->duplicates == 0)
+        return GAME_HINT_NONE;
+
+    copyBoard(board, scratch);
+    int solved = game->duplicates == 0 ? solveExactLimited(scratch, NULL, 0, GAME_HINT_SECONDS) : 0;
+    if (solved < 0)
+        return GAME_HINT_TIMEOUT;
+    if (solved == 1) {
+        // Pole z najmniejszą liczbą kandydatów - najbardziej "wymuszony" następny krok
+        uint64_t full = ((uint64_t)1 << size) - 1;
+        int best = -1, bestCount = size + 1;
+        for (int i = 0; i < n; i++) {
+            if (board->cells[i] != 0)
+                continue;
+            int unit[3];
+            unitsOf(board, i, unit);
+            int count = __builtin_popcountll(full & ~(game->used[0][unit[0]] | game->used[1][unit[1]] | game->used[2][unit[2]]));
+            if (count < bestCount) {
+                bestCount = count;
+                best = i;
+            }
+        }
+        if (best < 0)
+            return GAME_HINT_NONE;
+        *idx = best;
+        *val = scratch->cells[best];
+        gameSetCell(game, best, *val);
+        return GAME_HINT_PLACED;
+    }
+
+    // Wpisy gracza są sprzeczne - rozwiązujemy same pola stałe i szukamy pierwszego błędu
+    for (int i = 0; i < n; i++)
+        scratch->cells[i] = isFixedCell(board, i) ? board->cells[i] : 0;
+    solved = solveExactLimited(scratch, NULL, 0, GAME_HINT_SECONDS);
+    if (solved < 0)
+        return GAME_HINT_TIMEOUT;
+    if (solved == 0)
+        return GAME_HINT_NONE;
+    for (int i = 0; i < n; i++) {
+        if (board->cells[i] != 0 && board->cells[i] != scratch->cells[i]) {
+            *idx = i;
+            *val = scratch->cells[i];
+            game->lastIdx = i;
+            return GAME_HINT_WRONG;
+        }
+    }
+    return GAME_HINT_NONE;
+}
+
+/**
+ * Składa klatkę planszy w buforze i wypisuje ją jednym zapisem
+ * @param game - stan gry
+ * @param out - strumień wyjściowy
+ */
+void gameRender(GameState *game, FILE *out) {
+    const Board *board = game->board;
+    int size = board->size;
+    char *p = game->frame;
+
+    p += sprintf(p, "   ");
+    for (int c = 0; c < size; c++)
+        p += sprintf(p, "\033[1;32m%2d \033[0m", c + 1);
+    *p++ = '\n';
+
+    for (int r = 0; r < size; r++) {
+        p += sprintf(p, "\033[1;32m%2d \033[0m", r + 1);
+        for (int c = 0; c < size; c++) {
+            int idx = r * size + c;
+            int val = board->cells[idx];
+            if (val == 0) {
+                memcpy(p, " . ", 3);
+                p += 3;
+                continue;
+            }
+            // pogrubione - pola stałe, niebieskie - wpisy gracza, czerwone - konflikt, odwrócone - ostatni ruch
+            const char *color = gameCellConflicted(game, idx) ? "1;31" : isFixedCell(board, idx) ? "1" : "36";
+            p += sprintf(p, "\033[%s%sm%2d\033[0m ", color, idx == game->lastIdx ? ";7" : "", val);
+        }
+        *p++ = '\n';
+    }
+    fwrite(game->frame, 1, p - game->frame, out);
+    fflush(out);
+}
@@ -0,0 +1,131 @@
+/**
+ * Deklaracja stanu rozgrywki. Stan śledzi przyrostowo liczbę pustych pól oraz
+ * liczniki cyfr w każdym wierszu, kolumnie i podkwadracie, więc sprawdzenie ruchu,
+ * konfliktu pola i ukończenia gry kosztuje O(1). Każda zmiana trafia do dziennika,
+ * który obsługuje cofanie i ponawianie ruchów. Klatka planszy jest składana w jednym
+ * buforze i wypisywana jednym zapisem.
+ */
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+
+#define GAME_MOVE_OK 0 // ruch wykonany
+#define GAME_MOVE_CONFLICT 1 // ruch wykonany, ale cyfra powtarza się w wierszu, kolumnie lub podkwadracie
+#define GAME_MOVE_FIXED 2 // pole stałe - ruch odrzucony
+#define GAME_MOVE_UNCHANGED 3 // pole ma już tę wartość - ruch pominięty
+
+#define GAME_HINT_PLACED 0 // podpowiedź wpisana na planszę
+#define GAME_HINT_WRONG 1 // wpisy gracza wykluczają rozwiązanie; wskazano błędne pole
+#define GAME_HINT_NONE 2 // brak pustych pól
+#define GAME_HINT_TIMEOUT 3 // solver nie zmieścił się w limicie czasu podpowiedzi
+
+typedef struct {
+    int16_t idx; // indeks pola
+    uint8_t before; // wartość przed ruchem
+    uint8_t after; // wartość po ruchu
+} GameMove;
+
+typedef struct {
+    Board *board; // plansza gry (pola stałe oznaczone)
+    Board *scratch; // plansza robocza solvera podpowiedzi
+    int emptyCount; // liczba pustych pól
+    int duplicates; // suma nadmiarowych wystąpień cyfr we wszystkich jednostkach (0 - brak konfliktów)
+    uint8_t counts[3][MAX_SIZE][MAX_SIZE + 1]; // [wiersz/kolumna/podkwadrat][jednostka][cyfra] - liczba wystąpień
+    uint64_t used[3][MAX_SIZE]; // cyfry obecne w jednostce: bit (d - 1) oznacza cyfrę d
+    uint64_t clashing[3][MAX_SIZE]; // cyfry występujące w jednostce co najmniej dwa razy
+    GameMove *journal; // dziennik ruchów; [0, journalPos) wykonane, [journalPos, journalLen) do ponowienia
+    int journalLen; // liczba ruchów w dzienniku
+    int journalPos; // liczba wykonanych ruchów
+    int journalCapacity; // pojemność dziennika
+    int lastIdx; // ostatnio zmienione pole (wyróżniane na planszy) lub -1
+    char *frame; // bufor klatki planszy
+    size_t frameCapacity; // pojemność bufora klatki
+} GameState;
+
+/**
+ * Tworzy stan gry dla planszy i przelicza liczniki jednostek
+ * @param board - plansza gry (pozostaje własnością wywołującego)
+ * @return stan gry
+ */
+GameState *createGameState(Board *board);
+
+/**
+ * Zwalnia stan gry (bez planszy)
+ * @param game - stan gry
+ */
+void freeGameState(GameState *game);
+
+/**
+ * Wpisuje wartość w pole (0 czyści pole) i zapisuje ruch w dzienniku
+ * (ruchy do ponowienia są odrzucane)
+ * @param game - stan gry
+ * @param idx - indeks pola (r * size + c)
+ * @param val - wartość 0 .. size
+ * @return GAME_MOVE_OK, GAME_MOVE_CONFLICT, GAME_MOVE_FIXED lub GAME_MOVE_UNCHANGED
+ */
+int gameSetCell(GameState *game, int idx, int val);
+
+/**
+ * Sprawdza w O(1), czy cyfra powtórzyłaby się w jednostkach pola
+ * (bieżąca wartość samego pola nie jest liczona)
+ * @param game - stan gry
+ * @param idx - indeks pola
+ * @param val - cyfra 1 .. size
+ * @return 1 jeśli cyfra koliduje z innym polem wiersza, kolumny lub podkwadratu
+ */
+int gameWouldConflict(const GameState *game, int idx, int val);
+
+/**
+ * Sprawdza w O(1), czy wartość pola powtarza się w którejś z jego jednostek
+ * @param game - stan gry
+ * @param idx - indeks pola
+ * @return 1 dla pola w konflikcie, 0 w przeciwnym wypadku
+ */
+int gameCellConflicted(const GameState *game, int idx);
+
+/**
+ * Sprawdza w O(1), czy plansza jest pełna i bez konfliktów
+ * @param game - stan gry
+ * @return 1 jeśli zagadka jest rozwiązana
+ */
+int gameIsSolved(const GameState *game);
+
+/**
+ * Cofa ostatni ruch
+ * @param game - stan gry
+ * @return indeks zmienionego pola lub -1, gdy nie ma czego cofać
+ */
+int gameUndo(GameState *game);
+
+/**
+ * Ponawia ostatnio cofnięty ruch
+ * @param game - stan gry
+ * @return indeks zmienionego pola lub -1, gdy nie ma czego ponawiać
+ */
+int gameRedo(GameState *game);
+
+/**
+ * Podpowiedź: solver bitowy rozwiązuje bieżącą planszę (wraz z wpisami gracza)
+ * i wpisuje wartość w puste pole z najmniejszą liczbą kandydatów (ruch trafia do dziennika).
+ * Jeśli wpisy gracza wykluczają rozwiązanie, wskazywany jest błędny wpis. Każde rozwiązywanie
+ * ma limit czasu; po jego przekroczeniu podpowiedzi nie ma (GAME_HINT_TIMEOUT).
+ * @param game - stan gry
+ * @param idx - miejsce na indeks pola podpowiedzi lub błędnego wpisu
+ * @param val - miejsce na wpisaną wartość (dla GAME_HINT_WRONG - wartość poprawna)
+ * @return GAME_HINT_PLACED, GAME_HINT_WRONG, GAME_HINT_NONE lub GAME_HINT_TIMEOUT
+ */
+int gameHint(GameState *game, int *idx, int *val);
+
+/**
+ * Składa klatkę planszy (nagłówki, pola stałe, wpisy gracza, konflikty na czerwono,
+ * ostatni ruch podświetlony) w buforze i wypisuje ją jednym zapisem
+ * @param game - stan gry
+ * @param out - strumień wyjściowy
+ */
+void gameRender(GameState *game, FILE *out);
+
+#endif
@@ -1,147 +1,333 @@
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
-#include <math.h>
 #include "generateboard.h"
+#include "bitsolver.h"
+#include "presolve.h"
 
-/**
- * Funkcja sprawdza czy liczba nie występuje w podkwadracie o rozmiarze boxSize
- * @param grid - tablica Sudoku
- * @param boxSize - rozmiar podkwadratu (sqrt(size))
- * @param rowStart - indeks początkowego wiersza podkwadratu
- * @param colStart - indeks początkowego wiersza kolumny
- * @param num - sprawdzana liczba
- * @return 1 jeśli liczba nie występuje, 0 w przeciwnym wypadku
- */
-int unUsedInBox(int **grid, int boxSize, int rowStart, int colStart, int num) {
-    for (int i = 0; i < boxSize; i++)
-        for (int j = 0; j < boxSize; j++)
-            if (grid[rowStart + i][colStart + j] == num)
-                return 0;
-    return 1;
-}
+// Limit węzłów przeszukiwania na jedną próbę wypełnienia planszy (na pole planszy).
+// Czas wypełniania ma ciężki ogon - zamiast czekać, lepiej zacząć od nowej przekątnej.
+#define GENERATE_NODES_PER_CELL 50
+#define GENERATE_SECONDS 10.0 // domyślny limit czasu generateBoard
 
 /**
- * Funkcja wypełnia podkwadrat boxSize x boxSize unikalnymi liczbami
- * @param grid - tablica Sudoku
- * @param size - rozmiar całej planszy
- * @param boxSize - rozmiar podkwadratu
+ * Funkcja wypełnia podkwadrat boxSize x boxSize losową permutacją liczb 1..size
+ * @param board - plansza Sudoku
  * @param row - indeks wiersza początkowego
  * @param col - indeks kolumny początkowej
+ * @param rng - generator liczb losowych
  */
-void fillBox(int **grid, int size, int boxSize, int row, int col) {
-    int num;
-    for (int i = 0; i < boxSize; i++) {
-        for (int j = 0; j < boxSize; j++) {
-            do {
-                num = rand() % size + 1; // Losowanie liczby z zakresu 1 do size
-            } while (!unUsedInBox(grid, boxSize, row, col, num)); //powtarzaj aż znajdziesz unikalną liczbę
-            grid[row + i][col + j] = num;
-        }
+void fillBox(Board *board, int row, int col, Rng *rng) {
+    int size = board->size;
+    uint8_t digits[size];
+    for (int k = 0; k < size; k++)
+        digits[k] = (uint8_t)(k + 1);
+    // Tasowanie Fishera-Yatesa
+    for (int k = size - 1; k > 0; k--) {
+        int m = rngBounded(rng, k + 1);
+        uint8_t tmp = digits[k];
+        digits[k] = digits[m];
+        digits[m] = tmp;
     }
+    for (int i = 0; i < board->box_size; i++)
+        for (int j = 0; j < board->box_size; j++)
+            boardSet(board, row + i, col + j, digits[i * board->box_size + j]);
 }
+
 /**
- * Funkcja sprawdza czy liczba nie występuje w wierszu
- * @param grid - tablica Sudoku
- * @param size - rozmiar planszy
- * @param i - indeks wiersza
- * @param num - sprawdzana liczba
+ * Funkcja wypełnia podkwadraty na przekątnej planszy
+ * @param board - plansza Sudoku
+ * @param rng - generator liczb losowych
  */
-int unUsedInRow(int **grid, int size, int i, int num) {
-    for (int j = 0; j < size; j++)
-        if (grid[i][j] == num)
-            return 0;
-    return 1;
+void fillDiagonal(Board *board, Rng *rng) {
+    for (int i = 0; i < board->size; i += board->box_size)
+        fillBox(board, i, i, rng);
+}
+
+/**
+ * Zwraca czas monotoniczny w milisekundach
+ */
+static double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
 }
 
 /**
- * Funkcja Sprawdza czy liczba nie występuje w kolumnie
- * @param grid - tablica Sudoku
- * @param size - rozmiar planszy
- * @param j - indeks kolumny
- * @param num - sprawdzana liczba
+ * Główna funkcja generujaca planszę Sudoku.
+ * Podkwadraty na przekątnej są od siebie niezależne, więc wypełniane są losowo,
+ * a resztę planszy uzupełnia solver bitowy (bitsolver.c) z losową kolejnością kandydatów.
+ * Gdy solver przekroczy limit węzłów, generowanie zaczyna się od nowej losowej przekątnej.
+ * @param board - plansza do wypełnienia (rozmiar 4, 9, 16, 25 lub 36)
+ * @param rng - generator liczb losowych
+ * @return 1 jeśli plansza jest pełna, 0 po przekroczeniu GENERATE_SECONDS
  */
-int unUsedInCol(int **grid, int size, int j, int num) {
-    for (int i = 0; i < size; i++)
-        if (grid[i][j] == num)
+int generateBoard(Board *board, Rng *rng) {
+    return generateBoardWithin(board, rng, GENERATE_SECONDS);
+}
+
+/**
+ * Generuje planszę jak generateBoard, ale z limitem łącznego czasu wszystkich prób
+ * @param board - plansza do wypełnienia
+ * @param rng - generator liczb losowych
+ * @param timeLimit - maksymalny czas w sekundach (0 - bez limitu)
+ * @return 1 jeśli plansza jest pełna, 0 po przekroczeniu limitu czasu
+ */
+int generateBoardWithin(Board *board, Rng *rng, double timeLimit) {
+    long nodeLimit = (long)GENERATE_NODES_PER_CELL * board->size * board->size;
+    double deadline = timeLimit > 0 ? nowMs() + timeLimit * 1e3 : 0;
+    while (1) {
+        // Inicjalizacja planszy zerami
+        memset(board->cells, 0, board->size * board->size);
+        fillDiagonal(board, rng); // Wypełnij podkwadraty na przekątnej
+        double remaining = deadline > 0 ? (deadline - nowMs()) / 1e3 : 0;
+        if (deadline > 0 && remaining <= 0)
             return 0;
-    return 1;
+        if (solveExactLimited(board, rng, nodeLimit, remaining) == 1) //Wypełnij resztę
+            return 1;
+    }
 }
+
 /**
- * Funkcja sprawdzająca bezpieczne wstawienie liczby
- * @param grid - tablica Sudoku
- * @param size - rozmiar planszy
- * @param boxSize - rozmiar podkwadratu
- * @param i - indeks wiersza
- * @param j - indeks kolumny
- * @param num - sprawdzana liczba
+ * Wypełnia perm losową permutacją liczb 0..n-1 (tasowanie Fishera-Yatesa)
  */
-int checkIfSafe(int **grid, int size, int boxSize, int i, int j, int num) {
-    return unUsedInRow(grid, size, i, num) && //sprawdzanie wiersza
-           unUsedInCol(grid, size, j, num) &&//sprawdzanie kolumny
-           unUsedInBox(grid, boxSize, i - i % boxSize, j - j % boxSize, num);//sprawdzanie podkwadratu
+static void shuffleIndices(uint8_t *perm, int n, Rng *rng) {
+    for (int k = 0; k < n; k++)
+        perm[k] = (uint8_t)k;
+    for (int k = n - 1; k > 0; k--) {
+        int m = rngBounded(rng, k + 1);
+        uint8_t tmp = perm[k];
+        perm[k] = perm[m];
+        perm[m] = tmp;
+    }
 }
 
 /**
- * Funkcja wypełnia podkwadraty na przekątnej planszy
- * @param grid - tablica Sudoku
- * @param size - rozmiar planszy
- * @param boxSize - rozmiar podkwadratu
+ * Losuje odwzorowanie wierszy (lub kolumn) zachowujące poprawność planszy:
+ * permutację pasów i niezależną permutację wierszy wewnątrz każdego pasa
+ * @param map - wynik: map[r] to wiersz źródłowy dla wiersza r
+ * @param box - rozmiar podkwadratu
+ * @param rng - generator liczb losowych
  */
-void fillDiagonal(int **grid, int size, int boxSize) {
-    for (int i = 0; i < size; i += boxSize)
-        fillBox(grid, size, boxSize, i, i);
+static void bandPermutation(uint8_t *map, int box, Rng *rng) {
+    uint8_t bands[MAX_BOX_SIZE], inner[MAX_BOX_SIZE];
+    shuffleIndices(bands, box, rng);
+    for (int band = 0; band < box; band++) {
+        shuffleIndices(inner, box, rng);
+        for (int i = 0; i < box; i++)
+            map[band * box + i] = (uint8_t)(bands[band] * box + inner[i]);
+    }
 }
 
+/**
+ * Wypełnia dest obrazem planszy src w losowej symetrii Sudoku
+ * @param src - plansza źródłowa lub NULL dla planszy wzorcowej
+ *              (pole (r, c) = (r mod n) * n + r / n + c mod size, plus 1)
+ * @param dest - plansza docelowa; bitset pól stałych przenoszony tylko z src
+ * @param rng - generator liczb losowych
+ */
+static void applySymmetry(const Board *src, Board *dest, Rng *rng) {
+    int size = dest->size;
+    int box = dest->box_size;
+    uint8_t rows[MAX_SIZE], cols[MAX_SIZE], labels[MAX_SIZE], digits[MAX_SIZE + 1];
+    bandPermutation(rows, box, rng);
+    bandPermutation(cols, box, rng);
+    shuffleIndices(labels, size, rng);
+    digits[0] = 0; // puste pole pozostaje puste
+    for (int v = 1; v <= size; v++)
+        digits[v] = (uint8_t)(labels[v - 1] + 1);
+    int transpose = rngBounded(rng, 2);
+
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            int fromRow = transpose ? rows[c] : rows[r];
+            int fromCol = transpose ? cols[r] : cols[c];
+            int idx = r * size + c;
+            if (src == NULL) {
+                dest->cells[idx] = digits[((fromRow % box) * box + fromRow / box + fromCol) % size + 1];
+            } else {
+                int from = fromRow * size + fromCol;
+                dest->cells[idx] = digits[src->cells[from]];
+                setFixedCell(dest, idx, isFixedCell(src, from));
+            }
+        }
+    }
+}
 
 /**
- * Rekurencyjna funkcja wypełniająca resztę planszy
- * @param grid - tablica Sudoku
- * @param size - rozmiar planszy
- * @param boxSize - rozmiar podkwadratu
- * @param i - indeks wiersza
- * @param j - indeks kolumny
- * @return 1 jeśli udało się wypełnić plansze 0 w przeciwnym wypadku
+ * Przekształca planszę losową symetrią Sudoku
+ * @param src - plansza źródłowa (pełna lub z pustymi polami)
+ * @param dest - plansza docelowa tego samego rozmiaru (różna od src)
+ * @param rng - generator liczb losowych
  */
-int fillRemaining(int **grid, int size, int boxSize, int i, int j) {
-    if (i == size - 1 && j == size)//plansza gotowa 
-        return 1;
-    // przekroczenie ostatniej kolumny, przejście do następnego wiersza
-    if (j == size) {
-        i++;
-        j = 0;
+void transformBoard(const Board *src, Board *dest, Rng *rng) {
+    applySymmetry(src, dest, rng);
+}
+
+/**
+ * Generuje planszę przekształceniem planszy wzorcowej losową symetrią, w czasie O(size^2)
+ * @param board - plansza do wypełnienia
+ * @param rng - generator liczb losowych
+ */
+void generateBoardTransformed(Board *board, Rng *rng) {
+    applySymmetry(NULL, board, rng);
+}
+
+/**
+ * Generuje pełną planszę wybraną metodą
+ * @param board - plansza do wypełnienia
+ * @param generator - GENERATOR_BACKTRACK lub GENERATOR_TRANSFORM
+ * @param rng - generator liczb losowych
+ * @return 1 jeśli plansza jest pełna, 0 po przekroczeniu limitu czasu
+ */
+int generateGrid(Board *board, int generator, Rng *rng) {
+    if (generator != GENERATOR_TRANSFORM)
+        return generateBoard(board, rng);
+    generateBoardTransformed(board, rng);
+    return 1;
+}
+
+/**
+ * Zamienia nazwę metody generowania ("backtrack" lub "transform") na stałą GENERATOR_*
+ * @param name - nazwa metody
+ * @return stała metody lub -1 dla nieznanej nazwy
+ */
+int parseGenerator(const char *name) {
+    if (strcmp(name, "backtrack") == 0)
+        return GENERATOR_BACKTRACK;
+    if (strcmp(name, "transform") == 0)
+        return GENERATOR_TRANSFORM;
+    return -1;
+}
+
+/**
+ * Usuwa określoną liczbę pól z planszy
+ * @param board - pełna plansza
+ * @param num - liczba pól do usunięcia
+ * @param rng - generator liczb losowych
+ */
+void removeCells(Board *board, int num, Rng *rng) {
+    int cellCount = board->size * board->size;
+    int removed = 0;
+    int attempts = 0;
+    int maxAttempts = cellCount * 2; // Ograniczenie liczby prób
+    // usuwanie w losowych miejscach
+    while (removed < num && attempts < maxAttempts) {
+        int idx = rngBounded(rng, cellCount);
+        if (board->cells[idx] != 0) {
+            board->cells[idx] = 0;
+            setFixedCell(board, idx, 0);
+            removed++;
+        }
+        attempts++;
     }
-    // jesli komórka już wypełniona, przejście do następnej
-    if (grid[i][j] != 0)
-        return fillRemaining(grid, size, boxSize, i, j + 1);
-    // próba wypełnienia liczby od 1 do size
-    for (int num = 1; num <= size; num++) {
-        // sprawdzenie czy liczba może być bezpiecznie wstawiona
-        if (checkIfSafe(grid, size, boxSize, i, j, num)) {
-            grid[i][j] = num;
-            //rekurencyjne wypełnienie kolejnych komórek
-            if (fillRemaining(grid, size, boxSize, i, j + 1))
-                return 1;
-            grid[i][j] = 0;//cofniecie sie po niepowodzeniu wypełnienia (backtracking)
+    
+    if (removed < num) {
+        // Jeśli nie udało się usunąć wystarczającej liczby komórek,
+        // przejdź przez planszę i usuń pozostałe
+        for (int idx = 0; idx < cellCount && removed < num; idx++) {
+            if (board->cells[idx] != 0) {
+                board->cells[idx] = 0;
+                setFixedCell(board, idx, 0);
+                removed++;
+            }
         }
     }
-    return 0;
 }
 
+/**
+ * Usuwa pola z planszy tak, aby zagadka miała dokładnie jedno rozwiązanie,
+ * a jej ocena logiczna nie przekraczała maxGrade
+ * @param board - pełna plansza; usunięte pola są oznaczane jako niestałe
+ * @param num - docelowa liczba pustych pól
+ * @param maxGrade - najwyższa dopuszczalna ocena (GRADE_*); 0 - bez oceniania
+ * @param rng - generator liczb losowych
+ * @param stats - statystyki i czasy kroków (może być NULL)
+ * @return liczba faktycznie usuniętych pól
+ */
+static int carve(Board *board, int num, int maxGrade, Rng *rng, CarveStats *stats) {
+    int cellCount = board->size * board->size;
+    int order[cellCount];
+    for (int k = 0; k < cellCount; k++)
+        order[k] = k;
+    // Losowa kolejność prób (tasowanie Fishera-Yatesa)
+    for (int k = cellCount - 1; k > 0; k--) {
+        int m = rngBounded(rng, k + 1);
+        int tmp = order[k];
+        order[k] = order[m];
+        order[m] = tmp;
+    }
+
+    CarveStats local = {0};
+    if (stats == NULL)
+        stats = &local;
+    double *stepMs = stats->stepMs;
+    memset(stats, 0, sizeof(*stats));
+    stats->stepMs = stepMs;
+    double start = nowMs();
+
+    for (int k = 0; k < cellCount && stats->removed < num; k++) {
+        int idx = order[k];
+        int val = board->cells[idx];
+        if (val == 0)
+            continue;
 
+        double stepStart = nowMs();
+        board->cells[idx] = 0;
+        // Wystarczy sprawdzić, czy istnieje drugie rozwiązanie; ocena tylko dla jednoznacznych
+        if (countSolutions(board, 2) == 1 && (maxGrade == 0 || gradeBoard(board) <= maxGrade)) {
+            setFixedCell(board, idx, 0);
+            stats->removed++;
+        } else {
+            board->cells[idx] = (uint8_t)val;
+            stats->rejected++;
+        }
+        double step = nowMs() - stepStart;
+        if (stats->stepMs != NULL)
+            stats->stepMs[stats->attempts] = step;
+        if (step > stats->maxStepMs)
+            stats->maxStepMs = step;
+        stats->attempts++;
+    }
+
+    stats->totalMs = nowMs() - start;
+    return stats->removed;
+}
 
 /**
- * Główna funkcja generujaca planszę Sudoku
- * @param board - wskaźnik do tablicy 2D
- * @param size - rozmiar planszy (4, 9, 16)
+ * Usuwa pola z planszy tak, aby zagadka miała dokładnie jedno rozwiązanie
+ * @param board - pełna plansza; usunięte pola są oznaczane jako niestałe
+ * @param num - docelowa liczba pustych pól
+ * @param rng - generator liczb losowych
+ * @param stats - statystyki i czasy kroków (może być NULL)
+ * @return liczba faktycznie usuniętych pól
  */
-void generateBoard(int **board, int size) {
-    int boxSize = (int)sqrt(size); //Oblicz rozmiar podkwadratu
-    srand(time(NULL)); // Inicjalizacja generatora liczb losowych
-    // Inicjalizacja planszy zerami
-    for (int i = 0; i < size; i++)
-        for (int j = 0; j < size; j++)
-            board[i][j] = 0;
-    fillDiagonal(board, size, boxSize); // Wypełnij podkwadraty na przekątnej
-    fillRemaining(board, size, boxSize, 0, 0); //Wypełnij resztę
+int carveUnique(Board *board, int num, Rng *rng, CarveStats *stats) {
+    return carve(board, num, 0, rng, stats);
 }
 
+/**
+ * Generuje jednoznaczną zagadkę o zadanej ocenie logicznej
+ * @param solution - plansza na rozwiązanie
+ * @param puzzle - plansza na zagadkę (pola stałe oznaczone)
+ * @param grade - żądana ocena (GRADE_SINGLES .. GRADE_GUESSING)
+ * @param rng - generator liczb losowych
+ * @param maxAttempts - maksymalna liczba generowanych plansz
+ * @return ocena zwróconej zagadki (może być niższa od żądanej po wyczerpaniu prób);
+ *         0, jeśli plansza nie powstała w limicie czasu
+ */
+int generateRated(Board *solution, Board *puzzle, int grade, Rng *rng, int maxAttempts) {
+    int n = puzzle->size * puzzle->size;
+    int got = 0;
+    for (int attempt = 0; attempt < maxAttempts && got != grade; attempt++) {
+        if (!generateBoard(solution, rng))
+            return 0;
+        copyBoard(solution, puzzle);
+        for (int idx = 0; idx < n; idx++)
+            setFixedCell(puzzle, idx, 1);
+        // Usuwamy tyle pól, ile się da bez przekroczenia oceny - ocena rośnie wraz z lukami
+        carve(puzzle, n, grade, rng, NULL);
+        got = gradeBoard(puzzle);
+    }
+    return got;
+}
@@ -1,16 +1,117 @@
 /**
  * Deklaracja funkcji generującej poprawną planszę Sudoku 
- * o podanym rozmiarze (4x4, 9x9, 16x16)
+ * o podanym rozmiarze (od 4x4 do 36x36)
+ * oraz funkcji usuwającej pola w celu utworzenia zagadki.
+ * Funkcje nie korzystają ze stanu globalnego - każdy wątek podaje własny generator liczb losowych (rng.h).
  */
 #ifndef GENERATEBOARD_H
 #define GENERATEBOARD_H
 
+#include "board.h"
+#include "rng.h"
+
 /**
- * Generuje planszę Sudoku wypełnioną zgodnie z zasadami
- * @param board - tablica 2D do wypełnienia (musi być wcześniej zaalokowana)
- * @param size - rozmiar planszy (4, 9 lub 16)
+ * Generuje planszę Sudoku wypełnioną zgodnie z zasadami. Generowanie ma domyślny
+ * limit czasu 10 s (własny limit przyjmuje generateBoardWithin).
+ * @param board - plansza do wypełnienia (musi być wcześniej zaalokowana, rozmiar 4, 9, 16, 25 lub 36)
+ * @param rng - generator liczb losowych
+ * @return 1 jeśli plansza jest pełna, 0 po przekroczeniu limitu czasu (plansza niepełna)
  */
-void generateBoard(int **board, int size);
+int generateBoard(Board *board, Rng *rng);
 
-#endif
+/**
+ * Generuje planszę jak generateBoard z limitem łącznego czasu. Każda próba wypełnienia
+ * ma limit węzłów; po jego przekroczeniu generowanie zaczyna się od nowej losowej
+ * przekątnej, a po upływie timeLimit funkcja zwraca porażkę.
+ * @param board - plansza do wypełnienia (rozmiar 4, 9, 16, 25 lub 36)
+ * @param rng - generator liczb losowych
+ * @param timeLimit - maksymalny czas w sekundach (0 - bez limitu)
+ * @return 1 jeśli plansza jest pełna, 0 po przekroczeniu limitu czasu (plansza niepełna)
+ */
+int generateBoardWithin(Board *board, Rng *rng, double timeLimit);
+
+#define GENERATOR_BACKTRACK 0 // przekątna + solver bitowy z losową kolejnością (generateBoard)
+#define GENERATOR_TRANSFORM 1 // symetrie planszy wzorcowej (generateBoardTransformed)
+
+/**
+ * Przekształca planszę losową symetrią Sudoku: zmianą etykiet cyfr, permutacją wierszy
+ * w pasach i samych pasów, analogicznie kolumn w stosach i stosów oraz (z p = 1/2)
+ * transpozycją. Poprawna plansza przechodzi w poprawną, a zagadka w zagadkę o tej samej
+ * liczbie rozwiązań i tej samej ocenie logicznej; bitset pól stałych jest przenoszony.
+ * @param src - plansza źródłowa (pełna lub z pustymi polami)
+ * @param dest - plansza docelowa tego samego rozmiaru (różna od src)
+ * @param rng - generator liczb losowych
+ */
+void transformBoard(const Board *src, Board *dest, Rng *rng);
+
+/**
+ * Generuje planszę Sudoku losową symetrią planszy wzorcowej. Koszt jest stały, O(size^2),
+ * i nie zależy od szczęścia przeszukiwania, ale wszystkie plansze należą do jednej klasy
+ * równoważności - do zagadek o zróżnicowanej strukturze lepszy jest generateBoard.
+ * Bitset pól stałych nie jest zmieniany.
+ * @param board - plansza do wypełnienia (rozmiar 4, 9, 16, 25 lub 36)
+ * @param rng - generator liczb losowych
+ */
+void generateBoardTransformed(Board *board, Rng *rng);
+
+/**
+ * Generuje pełną planszę wybraną metodą
+ * @param board - plansza do wypełnienia
+ * @param generator - GENERATOR_BACKTRACK lub GENERATOR_TRANSFORM
+ * @param rng - generator liczb losowych
+ * @return 1 jeśli plansza jest pełna, 0 gdy generateBoard przekroczył limit czasu
+ */
+int generateGrid(Board *board, int generator, Rng *rng);
 
+/**
+ * Zamienia nazwę metody generowania ("backtrack" lub "transform") na stałą GENERATOR_*
+ * @param name - nazwa metody
+ * @return stała metody lub -1 dla nieznanej nazwy
+ */
+int parseGenerator(const char *name);
+
+/**
+ * Usuwa określoną liczbę pól z planszy i oznacza je jako niestałe
+ * @param board - pełna plansza
+ * @param num - liczba pól do usunięcia
+ * @param rng - generator liczb losowych
+ */
+void removeCells(Board *board, int num, Rng *rng);
+
+typedef struct {
+    int attempts;     // liczba prób usunięcia pola
+    int removed;      // liczba usuniętych pól
+    int rejected;     // liczba cofniętych usunięć (zagadka straciłaby jednoznaczność)
+    double totalMs;   // łączny czas wycinania w milisekundach
+    double maxStepMs; // najdłuższy pojedynczy krok (usunięcie + liczenie rozwiązań)
+    double *stepMs;   // opcjonalna tablica (size * size) czasów kolejnych prób; NULL jeśli niepotrzebna
+} CarveStats;
+
+/**
+ * Usuwa pola z planszy tak, aby zagadka miała dokładnie jedno rozwiązanie.
+ * Pola są próbowane w losowej kolejności; po każdym usunięciu solver bitowy liczy
+ * rozwiązania (do 2) i cofa usunięcie, które psuje jednoznaczność.
+ * @param board - pełna plansza; usunięte pola są oznaczane jako niestałe
+ * @param num - docelowa liczba pustych pól
+ * @param rng - generator liczb losowych
+ * @param stats - statystyki i czasy kroków (może być NULL)
+ * @return liczba faktycznie usuniętych pól (może być mniejsza niż num)
+ */
+int carveUnique(Board *board, int num, Rng *rng, CarveStats *stats);
+
+/**
+ * Generuje zagadkę o zadanej trudności logicznej (gradeBoard z presolve.h) zamiast
+ * liczby luk. Pola są wycinane w losowej kolejności z zachowaniem jednoznaczności,
+ * a usunięcie, po którym zagadka wymagałaby trudniejszej reguły, jest cofane.
+ * Jeśli wynik jest łatwiejszy od żądanego, próba jest powtarzana na nowej planszy.
+ * @param solution - plansza na pełne rozwiązanie
+ * @param puzzle - plansza na zagadkę; pozostawione pola są oznaczane jako stałe
+ * @param grade - żądana ocena (GRADE_SINGLES .. GRADE_GUESSING)
+ * @param rng - generator liczb losowych
+ * @param maxAttempts - maksymalna liczba generowanych plansz
+ * @return ocena zwróconej zagadki (niższa od żądanej, jeśli próby się wyczerpały);
+ *         0, gdy generateBoard przekroczył limit czasu i zagadki nie ma
+ */
+int generateRated(Board *solution, Board *puzzle, int grade, Rng *rng, int maxAttempts);
+
+#endif
@@ -2,117 +2,25 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <unistd.h>
+#include "board.h"
 #include "generateboard.h"
 #include "SA_algorithm.h"
+#include "batch.h"
+#include "server.h"
+#include "filesolve.h"
+#include "solvercontext.h"
+#include "rng.h"
+#include "energy.h"
+#include "presolve.h"
+#include "puzzlestore.h"
+#include "gamestate.h"
 
-#define MAX_SIZE 16 // Maksymalny rozmiar planszy
 //globalne zmienne przechowujace stan gry
-int **board; // Aktualna plansza gry
-int **solution; //pełne rozwiązanie planszy
-int **isFixed; // znacznik czy pole jest stałe
-int size; //Rozmiar planszy (4, 9 lub 16)
-
-/**
- * Alokuje pamięć dla dynamicznej tablicy 2D
- * @param size - rozmiar planszy
- * @return wskaźnik do zaalokowanej tablicy
- */
-int **allocateBoard(int size) {
-    int **grid = malloc(size * sizeof(int *));
-    for (int i = 0; i < size; i++)
-        grid[i] = calloc(size, sizeof(int));
-    return grid;
-}
-
-/**
- * Zwalnia pamięć zajmowaną przez tablicę 2D
- * @param grid - tablica do zwolnienia
- * @param size - rozmiar tablicy
- */
-void freeBoard(int **grid, int size) {
-    for (int i = 0; i < size; i++)
-        free(grid[i]);
-    free(grid);
-}
-
-/**
- * Kopiuje zawartość jednej tablicy do drugiej
- * @param src - tablica źródłowa
- * @param dest - tablica docelowa
- */
-void copyBoard(int **src, int **dest) {
-    for (int i = 0; i < size; i++)
-        for (int j = 0; j < size; j++)
-            dest[i][j] = src[i][j];
-}
-
-/**
- * Usuwa określoną liczbę pól z planszy
- * @param num - liczba pól do usunięcia
- */
-void removeCells(int num) {
-    int removed = 0;
-    int attempts = 0;
-    int maxAttempts = size * size * 2; // Ograniczenie liczby prób
-    // usuwanie w losowych miejscach
-    while (removed < num && attempts < maxAttempts) {
-        int r = rand() % size;
-        int c = rand() % size;
-        if (board[r][c] != 0) {
-            board[r][c] = 0;
-            isFixed[r][c] = 0;
-            removed++;
-        }
-        attempts++;
-    }
-    
-    if (removed < num) {
-        // Jeśli nie udało się usunąć wystarczającej liczby komórek,
-        // przejdź przez planszę i usuń pozostałe
-        for (int i = 0; i < size && removed < num; i++) {
-            for (int j = 0; j < size && removed < num; j++) {
-                if (board[i][j] != 0) {
-                    board[i][j] = 0;
-                    isFixed[i][j] = 0;
-                    removed++;
-                }
-            }
-        }
-    }
-}
-
-/**
- * Wyświetla aktualny stan planszy w terminalu
- * z kolorowym oznaczeniem wierszy i kolumn
- */
-void printBoard() {
-    printf("   ");
-    for (int i = 0; i < size; i++) printf("\033[1;32m%2d \033[0m", i + 1);
-    printf("\n");
-
-    for (int i = 0; i < size; i++) {
-        printf("\033[1;32m%2d \033[0m", i + 1);
-        for (int j = 0; j < size; j++) {
-            if (board[i][j] == 0)
-                printf(" . ");
-            else
-                printf("%2d ", board[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-/**
- * Sprawdza czy wszystkie pola są wypełnione
- * @return 1 jeśli plansza jest pełna, 0 w przeciwnym wypadku
- */
-int isFinished() {
-    for (int i = 0; i < size; i++)
-        for (int j = 0; j < size; j++)
-            if (board[i][j] == 0)
-                return 0;
-    return 1;
-}
+Board *board; // Aktualna plansza gry (wraz ze znacznikami pól stałych)
+Board *solution; //pełne rozwiązanie planszy
+int size; //Rozmiar planszy (4, 9, 16, 25 lub 36)
+Rng rng; // generator liczb losowych gry (ziarno z --seed lub z zegara)
 
 /**
  * Wyświetla instrukcję gry
@@ -137,6 +45,9 @@ void showInstructions() {
     printf("6. Pamiętaj, że tylko niektóre komórki są stałe (ich wartości są ustalone na początku)\n");
     printf("   i nie możesz ich zmieniać.\n\n");
 
+    printf("7. Liczby powtarzające się w wierszu, kolumnie lub kwadracie są oznaczane na czerwono.\n");
+    printf("   Wpisz c, aby cofnąć ruch, p, aby go ponowić, lub h, aby otrzymać podpowiedź.\n\n");
+
     printf("Powodzenia!\n");
     printf("=====================================\n\n");
 }
@@ -149,104 +60,117 @@ void playGame() {
     char input[100];
     time_t startTime = time(NULL);
     int moveCount = 0;
-    if (size == 9) {
-        char choice;
-        printBoard();
-        printf("Czy chcesz wykorzystać algorytm SA do rozwiązania Sudoku? (T/N): ");
-        scanf(" %c", &choice);  
-        while(getchar() != '\n'); // Clear input buffer
-    
-        if (choice == 'T' || choice == 't') {
-            printf("Uruchamianie algorytmu wyżarzania...\n");
-            double T_start = 5.0;
-            double T_end = 1e-3;
-            double alpha = 0.999;
-            int max_iterations = 1000000;
-            
-            // Make a copy of isFixed for SA algorithm
-            int **fixed_copy = allocateBoard(size);
-            for (int i = 0; i < size; i++) {
-                memcpy(fixed_copy[i], isFixed[i], size * sizeof(int));
-            }
-            
-            solve_sudoku_sa(board, fixed_copy, size, T_start, T_end, alpha, max_iterations);
-            
-            // Update isFixed based on solution
-            for (int i = 0; i < size; i++) {
-                for (int j = 0; j < size; j++) {
-                    if (board[i][j] != 0) {
-                        isFixed[i][j] = 1;
-                    }
-                }
+    char choice;
+    GameState *game = createGameState(board);
+    gameRender(game, stdout);
+    printf("Czy chcesz wykorzystać algorytm SA do rozwiązania Sudoku? (T/N): ");
+    scanf(" %c", &choice);  
+    while(getchar() != '\n'); // Clear input buffer
+
+    if (choice == 'T' || choice == 't') {
+        printf("Uruchamianie algorytmu wyżarzania...\n");
+        // Schemat adaptacyjny z finiszem dokładnym: plateau z niską energią dokańcza solver bitowy
+        int max_iterations = 5000000;
+        double time_limit = 60.0; // łącznie z dokończeniem solverem dokładnym dużych plansz
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        SAStats stats = solve_sudoku_sa_hybrid(board, max_iterations, cores > 1 ? (int)cores : 1, rngNext(&rng),
+                                               NULL, time_limit);
+        printf("Propagacja ograniczeń: wypełniono %d pól\n", stats.presolved_cells);
+        printf("Finalna energia: %d (iteracje: %ld, czas: %.3f s)\n", stats.best_energy, stats.iterations,
+               stats.presolve_seconds + stats.init_seconds + stats.anneal_seconds);
+        if (stats.finished_exact)
+            printf("Planszę dokończył solver dokładny.\n");
+
+        if (isValidSolution(board))
+            printf("Weryfikacja: rozwiązanie poprawne.\n");
+        else
+            printf("Weryfikacja: plansza zawiera konflikty lub puste pola.\n");
+
+        // Update isFixed based on solution
+        for (int idx = 0; idx < size * size; idx++) {
+            if (board->cells[idx] != 0) {
+                setFixedCell(board, idx, 1);
             }
-            
-            freeBoard(fixed_copy, size);
-            printBoard();
-            exit(0);
         }
+        
+        freeGameState(game);
+        game = createGameState(board); // plansza zmieniona poza stanem gry
+        gameRender(game, stdout);
+        exit(0);
     }
+
     while (1) {
-        printBoard();
+        gameRender(game, stdout);
         printf("\nPodaj: wiersz kolumna wartość (1-%d)\n", size);
         printf("Użyj wartości 0, aby usunąć wpis. Wpisz 0 0 0, aby zakończyć grę.\n");
+        printf("c - cofnij, p - ponów, h - podpowiedź (pozostało pustych pól: %d)\n", game->emptyCount);
         printf("Twój ruch: ");
         
         // Najpierw wczytaj całą linię
         if (fgets(input, sizeof(input), stdin) == NULL) {
-            printf("Błąd odczytu. Spróbuj ponownie.\n");
-            continue;
-        }
-        
-        // Następnie parsuj dane
-        if (sscanf(input, "%d %d %d", &row, &col, &val) != 3) {
-            printf("Nieprawidłowy format. Wprowadź 3 liczby oddzielone spacjami.\n\n");
-            continue;
-        }
-
-        // Reszta kodu pozostaje bez zmian
-        if (row == 0 && col == 0 && val == 0) {
-            printf("Gra zakończona. Do zobaczenia!\n");
+            printf("Błąd odczytu. Koniec gry.\n");
             break;
         }
-        // Walidacja zakresów
-        if (row < 1 || row > size || col < 1 || col > size || val < 0 || val > size) {
-            printf("Nieprawidłowe dane. Spróbuj ponownie.\n\n");
-            continue;
-        }
-
-        row--; col--; // Konwersja na indeksy od 0
-
-        // Sprawdzenie czy pole jest stałe
-        if (isFixed[row][col]) {
-            printf("Nie można zmienić tej komórki - to pole jest stałe.\n\n");
-            moveCount++;
-            continue;
-        }
 
-        // Obsługa usuwania wartości
-        if (val == 0) {
-            if (board[row][col] == 0) {
-                printf("To pole jest już puste.\n\n");
-                moveCount++;
+        // Polecenia jednoliterowe
+        char command;
+        if (sscanf(input, " %c", &command) == 1 && (command == 'c' || command == 'p' || command == 'h')) {
+            if (command == 'c') {
+                printf(gameUndo(game) >= 0 ? "Ruch cofnięty.\n\n" : "Nie ma ruchów do cofnięcia.\n\n");
+            } else if (command == 'p') {
+                printf(gameRedo(game) >= 0 ? "Ruch ponowiony.\n\n" : "Nie ma ruchów do ponowienia.\n\n");
             } else {
-                board[row][col] = 0;
-                printf("Ruch został usunięty.\n\n");
+                int hintIdx, hintVal;
+                int hint = gameHint(game, &hintIdx, &hintVal);
+                if (hint == GAME_HINT_PLACED)
+                    printf("Podpowiedź: %d w polu (%d, %d).\n\n", hintVal, hintIdx / size + 1, hintIdx % size + 1);
+                else if (hint == GAME_HINT_WRONG)
+                    printf("Pole (%d, %d) jest wypełnione błędnie - powinno być %d.\n\n",
+                           hintIdx / size + 1, hintIdx % size + 1, hintVal);
+                else if (hint == GAME_HINT_TIMEOUT)
+                    printf("Nie udało się znaleźć podpowiedzi w limicie czasu.\n\n");
+                else
+                    printf("Brak podpowiedzi.\n\n");
+                moveCount++;
             }
-            continue;
-        }
-
-        // Weryfikacja ruchu
-        if (solution[row][col] == val) {
-            board[row][col] = val;
-            printf("Poprawny ruch!\n\n");
-            moveCount++;
         } else {
-            printf("Błąd! Ta liczba nie pasuje w tym miejscu.\n\n");
+            // Następnie parsuj dane
+            if (sscanf(input, "%d %d %d", &row, &col, &val) != 3) {
+                printf("Nieprawidłowy format. Wprowadź 3 liczby oddzielone spacjami.\n\n");
+                continue;
+            }
+
+            if (row == 0 && col == 0 && val == 0) {
+                printf("Gra zakończona. Do zobaczenia!\n");
+                break;
+            }
+            // Walidacja zakresów
+            if (row < 1 || row > size || col < 1 || col > size || val < 0 || val > size) {
+                printf("Nieprawidłowe dane. Spróbuj ponownie.\n\n");
+                continue;
+            }
+
+            row--; col--; // Konwersja na indeksy od 0
             moveCount++;
+            // Stan gry sprawdza pole stałe i konflikty w O(1) i zapisuje ruch w dzienniku
+            switch (gameSetCell(game, row * size + col, val)) {
+            case GAME_MOVE_FIXED:
+                printf("Nie można zmienić tej komórki - to pole jest stałe.\n\n");
+                break;
+            case GAME_MOVE_UNCHANGED:
+                printf(val == 0 ? "To pole jest już puste.\n\n" : "To pole ma już tę wartość.\n\n");
+                break;
+            case GAME_MOVE_CONFLICT:
+                printf("Konflikt! Liczba %d powtarza się w wierszu, kolumnie lub kwadracie.\n\n", val);
+                break;
+            default:
+                printf(val == 0 ? "Ruch został usunięty.\n\n" : "Ruch zapisany.\n\n");
+                break;
+            }
         }
 
         // Sprawdzenie ukończenia gry
-        if (isFinished()) {
+        if (gameIsSolved(game)) {
             time_t endTime = time(NULL);
             int duration = (int)(endTime - startTime);
             int minutes = duration / 60;
@@ -254,32 +178,212 @@ void playGame() {
             printf("Gratulacje! Sudoku zostało rozwiązane!\n");
             printf("Czas gry: %d minut i %d sekund.\n", minutes, seconds);
             printf("Ilość wykonanych prob: %d\n", moveCount);
-            printBoard();
+            gameRender(game, stdout);
             break;
         }
     }
+    freeGameState(game);
+}
+
+/**
+ * Odczytuje ocenę trudności zapisaną jako "L1" .. "L5"
+ * @param text - tekst argumentu
+ * @return ocena GRADE_* lub 0, jeśli tekst nie jest oceną
+ */
+static int parseGrade(const char *text) {
+    if (text[0] != 'L' && text[0] != 'l')
+        return 0;
+    int grade = atoi(text + 1);
+    return grade >= GRADE_SINGLES && grade <= GRADE_GUESSING ? grade : 0;
+}
+
+/**
+ * Obsługuje tryb wsadowy: main batch <liczba> <rozmiar> <luki|L1-L5> <wątki> <plik> [ziarno] [backtrack|transform]
+ * @return kod wyjścia programu
+ */
+int batchMain(int argc, char **argv) {
+    if (argc < 7) {
+        printf("Użycie: %s batch <liczba> <rozmiar> <luki|L1-L5> <wątki> <plik> [ziarno] [backtrack|transform]\n", argv[0]);
+        return 1;
+    }
+    int count = atoi(argv[2]);
+    int batchSize = atoi(argv[3]);
+    int grade = parseGrade(argv[4]);
+    int holes = grade > 0 ? 0 : atoi(argv[4]);
+    int threads = atoi(argv[5]);
+    uint64_t seed = argc > 7 ? strtoull(argv[7], NULL, 10) : (uint64_t)time(NULL);
+    int generator = parseGenerator(argc > 8 ? argv[8] : "transform");
+
+    if (boardBoxSize(batchSize) == 0) {
+        printf("Nieobsługiwany rozmiar. Dostępne: 4, 9, 16, 25, 36\n");
+        return 1;
+    }
+    if (count < 1 || holes < 0 || holes > batchSize * batchSize - 1 || threads < 1 || generator < 0) {
+        printf("Nieprawidłowe parametry trybu wsadowego.\n");
+        return 1;
+    }
+    return runBatch(count, batchSize, holes, grade, generator, threads, argv[6], seed);
+}
+
+/**
+ * Obsługuje tryb serwera: main serve <gniazdo> [wątki] [ziarno] [limit_ms]
+ * @return kod wyjścia programu
+ */
+int serveMain(int argc, char **argv) {
+    if (argc < 3) {
+        printf("Użycie: %s serve <gniazdo> [wątki] [ziarno] [limit_ms]\n", argv[0]);
+        return 1;
+    }
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = argc > 3 ? atoi(argv[3]) : (cores > 1 ? (int)cores : 1);
+    uint64_t seed = argc > 4 ? strtoull(argv[4], NULL, 10) : (uint64_t)time(NULL);
+    long timeLimitMs = argc > 5 ? atol(argv[5]) : 0;
+    if (threads < 1) {
+        printf("Nieprawidłowa liczba wątków.\n");
+        return 1;
+    }
+    if (timeLimitMs < 0) {
+        printf("Nieprawidłowy limit czasu.\n");
+        return 1;
+    }
+    return runServer(argv[2], threads, seed, timeLimitMs);
+}
+
+/**
+ * Obsługuje rozwiązywanie pliku: main solve <wejście> <wyjście> [wątki] [exact|sa|hybrid|batch] [ziarno]
+ * @return kod wyjścia programu
+ */
+int solveMain(int argc, char **argv) {
+    if (argc < 4) {
+        printf("Użycie: %s solve <wejście> <wyjście> [wątki] [exact|sa|hybrid|batch] [ziarno]\n", argv[0]);
+        return 1;
+    }
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = argc > 4 ? atoi(argv[4]) : (cores > 1 ? (int)cores : 1);
+    int method = parseSolveMethod(argc > 5 ? argv[5] : "exact");
+    uint64_t seed = argc > 6 ? strtoull(argv[6], NULL, 10) : (uint64_t)time(NULL);
+    if (threads < 1) {
+        printf("Nieprawidłowa liczba wątków.\n");
+        return 1;
+    }
+    if (method < 0) {
+        printf("Nieznana metoda: %s (dostępne: exact, sa, hybrid, batch)\n", argv[5]);
+        return 1;
+    }
+    return runFileSolve(argv[2], argv[3], threads, method, seed);
+}
+
+/**
+ * Obsługuje magazyn zagadek:
+ *   main store build <magazyn> <zagadki>...
+ *   main store list <magazyn>
+ *   main store pick <magazyn> <rozmiar> <L1-L5> <liczba> [ziarno]
+ * @return kod wyjścia programu
+ */
+int storeMain(int argc, char **argv) {
+    if (argc >= 5 && strcmp(argv[2], "build") == 0)
+        return buildPuzzleStore(argv[3], argv + 4, argc - 4);
+    if (argc == 4 && strcmp(argv[2], "list") == 0) {
+        PuzzleStore *store = openPuzzleStore(argv[3]);
+        if (store == NULL)
+            return 1;
+        describePuzzleStore(store, stdout);
+        closePuzzleStore(store);
+        return 0;
+    }
+    if (argc >= 7 && strcmp(argv[2], "pick") == 0) {
+        int pickSize = atoi(argv[4]);
+        int grade = parseGrade(argv[5]);
+        long count = atol(argv[6]);
+        uint64_t seed = argc > 7 ? strtoull(argv[7], NULL, 10) : (uint64_t)time(NULL);
+        if (boardBoxSize(pickSize) == 0 || grade == 0 || count < 1) {
+            printf("Nieprawidłowe parametry wyboru zagadek.\n");
+            return 1;
+        }
+        PuzzleStore *store = openPuzzleStore(argv[3]);
+        if (store == NULL)
+            return 1;
+        Board *puzzle = allocateBoard(pickSize);
+        Board *answer = allocateBoard(pickSize);
+        Rng pickRng;
+        rngSeed(&pickRng, seed);
+        int n = pickSize * pickSize;
+        int failed = 0;
+        // Wyjście w formacie trybu wsadowego: "<zagadka> <rozwiązanie>"
+        for (long i = 0; i < count; i++) {
+            int picked = pickStoredPuzzle(store, grade, &pickRng, puzzle, answer);
+            if (picked != 0) {
+                if (picked == -2)
+                    fprintf(stderr, "Uszkodzony rekord zagadki %dx%d o ocenie L%d w magazynie\n", pickSize, pickSize, grade);
+                else
+                    fprintf(stderr, "Magazyn nie zawiera zagadek %dx%d o ocenie L%d\n", pickSize, pickSize, grade);
+                failed = 1;
+                break;
+            }
+            for (int idx = 0; idx < n; idx++)
+                putchar(cellToChar(puzzle->cells[idx]));
+            putchar(' ');
+            for (int idx = 0; idx < n; idx++)
+                putchar(cellToChar(answer->cells[idx]));
+            putchar('\n');
+        }
+        freeBoard(puzzle);
+        freeBoard(answer);
+        closePuzzleStore(store);
+        return failed;
+    }
+    printf("Użycie: %s store build <magazyn> <zagadki>...\n"
+           "       %s store list <magazyn>\n"
+           "       %s store pick <magazyn> <rozmiar> <L1-L5> <liczba> [ziarno]\n", argv[0], argv[0], argv[0]);
+    return 1;
 }
 
 /**
  * Główna funkcja programu
+ * Tryb interaktywny: main [--seed ziarno]
  */
-int main() {
-    srand(time(NULL));
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "batch") == 0)
+        return batchMain(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "serve") == 0)
+        return serveMain(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "solve") == 0)
+        return solveMain(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "store") == 0)
+        return storeMain(argc, argv);
+
+    uint64_t seed = (uint64_t)time(NULL);
+    const char *storePath = NULL;
+    int generator = GENERATOR_TRANSFORM;
+    for (int arg = 1; arg + 1 < argc; arg += 2) {
+        if (strcmp(argv[arg], "--seed") == 0)
+            seed = strtoull(argv[arg + 1], NULL, 10); // powtarzalna rozgrywka
+        else if (strcmp(argv[arg], "--store") == 0)
+            storePath = argv[arg + 1]; // gotowe zagadki zamiast generowania
+        else if (strcmp(argv[arg], "--generator") == 0 && parseGenerator(argv[arg + 1]) >= 0)
+            generator = parseGenerator(argv[arg + 1]);
+    }
+    rngSeed(&rng, seed);
     showInstructions();
     // Wybór rozmiaru planszy
-    printf("Wybierz rozmiar planszy (4, 9, 16): ");
+    printf("Wybierz rozmiar planszy (4, 9, 16, 25, 36): ");
     scanf("%d", &size);
-    if (size != 4 && size != 9 && size != 16) {
-        printf("Nieobsługiwany rozmiar. Dostępne: 4, 9, 16\n");
+    if (boardBoxSize(size) == 0) {
+        printf("Nieobsługiwany rozmiar. Dostępne: 4, 9, 16, 25, 36\n");
         return 1;
     }
-    // Wybór trudności
-    int difficulty;
+    // Wybór trudności: liczba pustych pól albo ocena logiczna L1 - L5
+    int difficulty = 0;
+    int grade = 0;
         while (1) {
-            printf("Wybierz poziom trudności (liczbę pustych pol od 1 - %d): ", size * size - 1);
+            printf("Wybierz poziom trudności (liczbę pustych pol od 1 - %d lub ocenę L1 - L5): ", size * size - 1);
     
-        if (scanf("%d", &difficulty) != 1) {  // Jeśli scanf nie wczyta liczby
-            printf("Nieprawidłowe dane. Wprowadź liczbę.\n");
+        char choice[16];
+        if (scanf("%15s", choice) != 1)
+            return 1;
+        grade = parseGrade(choice);
+        if (grade == 0 && sscanf(choice, "%d", &difficulty) != 1) {  // Ani ocena, ani liczba
+            printf("Nieprawidłowe dane. Wprowadź liczbę lub L1 - L5.\n");
             while (getchar() != '\n');  // Wyczyść bufer wejścia
             continue;
         }
@@ -294,39 +398,61 @@ int main() {
     // Inicjalizacja plansz
     board = allocateBoard(size);
     solution = allocateBoard(size);
-    isFixed = allocateBoard(size);
-
-    // Generuj planszę w pętli aż będzie poprawna
-    int valid = 0;
-        while (!valid) {
-            generateBoard(solution, size);
-            valid = 1;
-            
-            // Dodatkowa weryfikacja dla 4x4
-            if (size == 4) {
-                for (int i = 0; i < size && valid; i++) {
-                    for (int j = 0; j < size && valid; j++) {
-                        if (solution[i][j] == 0) {
-                            valid = 0;
-                        }
-                    }
-                }
+
+    if (grade > 0) {
+        PuzzleStore *store = storePath != NULL ? openPuzzleStore(storePath) : NULL;
+        if (store != NULL && pickStoredPuzzle(store, grade, &rng, board, solution) == 0) {
+            printf("Ocena zagadki: %s (L%d), zagadka z magazynu %s\n\n", gradeName(grade), grade, storePath);
+        } else {
+            if (storePath != NULL)
+                printf("Brak zagadek %dx%d o ocenie L%d w magazynie - generowanie nowej.\n", size, size, grade);
+            // Wycinanie sterowane oceną logiczną zamiast liczby luk
+            int got = generateRated(solution, board, grade, &rng, 50);
+            if (got == 0) {
+                printf("Nie udało się wygenerować planszy w limicie czasu.\n");
+                if (store != NULL)
+                    closePuzzleStore(store);
+                freeBoard(board);
+                freeBoard(solution);
+                return 1;
             }
+            printf("Ocena zagadki: %s (L%d)\n\n", gradeName(got), got);
+            if (got != grade)
+                printf("Nie udało się uzyskać oceny L%d - zagadka jest łatwiejsza.\n\n", grade);
         }
+        if (store != NULL)
+            closePuzzleStore(store);
+        playGame();
+        freeBoard(board);
+        freeBoard(solution);
+        return 0;
+    }
+
+    // Obie metody zwracają pełną, poprawną planszę; generator z przeszukiwaniem ma limit czasu
+    if (!generateGrid(solution, generator, &rng)) {
+        printf("Nie udało się wygenerować planszy w limicie czasu.\n");
+        freeBoard(board);
+        freeBoard(solution);
+        return 1;
+    }
 
     copyBoard(solution, board);
      // Oznaczenie stałych pól
-    for (int i = 0; i < size; i++)
-        for (int j = 0; j < size; j++)
-            isFixed[i][j] = 1;
-    removeCells(difficulty);// Usunięcie części pól
+    for (int idx = 0; idx < size * size; idx++)
+        setFixedCell(board, idx, 1);
+    // Usunięcie części pól z zachowaniem jednoznaczności rozwiązania
+    CarveStats carve = {0};
+    int removed = carveUnique(board, difficulty, &rng, &carve);
+    if (removed < difficulty)
+        printf("Zagadka z jednym rozwiązaniem pozwala usunąć tylko %d pól (żądano %d).\n", removed, difficulty);
+    printf("Wycinanie pól: %d prób, %d cofniętych, %.2f ms (najdłuższy krok %.3f ms)\n\n",
+           carve.attempts, carve.rejected, carve.totalMs, carve.maxStepMs);
 
     playGame();// Rozpoczęcie gry
         // Zwolnienie pamięci
 
-    freeBoard(board, size);
-    freeBoard(solution, size);
-    freeBoard(isFixed, size);
+    freeBoard(board);
+    freeBoard(solution);
     return 0;
 }
 
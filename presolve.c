@@ -0,0 +1,452 @@
+#include <stdlib.h>
+#include <string.h>
+#include "presolve.h"
+
+#define POPCOUNT(x) __builtin_popcountll(x)
+#define CTZ(x) __builtin_ctzll(x)
+
+typedef struct {
+    int size;        // rozmiar planszy
+    int boxSize;     // rozmiar podkwadratu
+    uint64_t full;   // maska wszystkich cyfr: bit (d - 1) oznacza cyfrę d
+    uint8_t *cells;  // robocza kopia komórek (tylko pola stałe i wymuszone)
+    uint64_t *cand;  // kandydaci pustych pól (0 dla pól wypełnionych)
+    int filled;      // liczba pól wypełnionych przez propagację
+} Presolver;
+
+/**
+ * Zwraca indeks pola we współrzędnych linii: pozycja pos w wierszu (rowMajor = 1)
+ * lub w kolumnie (rowMajor = 0) numer line. Podkwadraty są kwadratowe, więc te same
+ * reguły działają dla wierszy i kolumn po zamianie współrzędnych.
+ */
+static inline int lineCell(const Presolver *p, int line, int pos, int rowMajor) {
+    return rowMajor ? line * p->size + pos : pos * p->size + line;
+}
+
+/**
+ * Przygotowuje kopię komórek i maski kandydatów
+ * @param p - kontekst propagacji
+ * @param board - plansza wejściowa (brane są pod uwagę tylko pola stałe)
+ * @return 1 jeśli pola stałe są niesprzeczne, 0 w przeciwnym wypadku
+ */
+static int initPresolver(Presolver *p, const Board *board) {
+    int size = board->size;
+    int n = size * size;
+    uint64_t rows[64] = {0}, cols[64] = {0}, boxes[64] = {0};
+
+    p->size = size;
+    p->boxSize = board->box_size;
+    p->full = size == 64 ? ~(uint64_t)0 : ((uint64_t)1 << size) - 1;
+    p->cells = malloc(n);
+    p->cand = malloc(n * sizeof(uint64_t));
+    p->filled = 0;
+
+    for (int idx = 0; idx < n; idx++) {
+        int r = idx / size, c = idx % size;
+        int b = (r / p->boxSize) * p->boxSize + c / p->boxSize;
+        int val = isFixedCell(board, idx) ? board->cells[idx] : 0;
+        p->cells[idx] = (uint8_t)val;
+        if (val == 0)
+            continue;
+        uint64_t bit = (uint64_t)1 << (val - 1);
+        if ((rows[r] | cols[c] | boxes[b]) & bit)
+            return 0; // ta sama cyfra dwa razy w jednej jednostce
+        rows[r] |= bit;
+        cols[c] |= bit;
+        boxes[b] |= bit;
+    }
+    for (int idx = 0; idx < n; idx++) {
+        int r = idx / size, c = idx % size;
+        int b = (r / p->boxSize) * p->boxSize + c / p->boxSize;
+        p->cand[idx] = p->cells[idx] ? 0 : p->full & ~(rows[r] | cols[c] | boxes[b]);
+    }
+    return 1;
+}
+
+/**
+ * Wpisuje cyfrę w pole i usuwa ją z kandydatów pól w tym samym wierszu, kolumnie i podkwadracie
+ * @param p - kontekst propagacji
+ * @param idx - indeks pola
+ * @param val - wpisywana cyfra
+ */
+static void placeDigit(Presolver *p, int idx, int val) {
+    int size = p->size, box = p->boxSize;
+    int r = idx / size, c = idx % size;
+    int br = (r / box) * box, bc = (c / box) * box;
+    uint64_t keep = ~((uint64_t)1 << (val - 1));
+
+    p->cells[idx] = (uint8_t)val;
+    p->cand[idx] = 0;
+    for (int k = 0; k < size; k++) {
+        p->cand[r * size + k] &= keep;
+        p->cand[k * size + c] &= keep;
+        p->cand[(br + k / box) * size + bc + k % box] &= keep;
+    }
+    p->filled++;
+}
+
+/**
+ * Wypełnia nagie single - pola z dokładnie jednym kandydatem
+ * @param p - kontekst propagacji
+ * @return liczba wypełnionych pól lub -1, jeśli któreś puste pole nie ma kandydatów
+ */
+static int nakedSingles(Presolver *p) {
+    int n = p->size * p->size;
+    int placed = 0;
+    for (int idx = 0; idx < n; idx++) {
+        if (p->cells[idx] != 0)
+            continue;
+        uint64_t mask = p->cand[idx];
+        if (mask == 0)
+            return -1;
+        if ((mask & (mask - 1)) == 0) {
+            placeDigit(p, idx, CTZ(mask) + 1);
+            placed++;
+        }
+    }
+    return placed;
+}
+
+/**
+ * Wypisuje indeksy pól jednostki: u < size - wiersz, u < 2 * size - kolumna, dalej podkwadrat
+ * @param p - kontekst propagacji
+ * @param u - numer jednostki (0 .. 3 * size - 1)
+ * @param unit - wynik: size indeksów pól
+ */
+static void unitCells(const Presolver *p, int u, int *unit) {
+    int size = p->size, box = p->boxSize;
+    int k = u % size;
+    for (int i = 0; i < size; i++) {
+        if (u < size)
+            unit[i] = k * size + i; // wiersz
+        else if (u < 2 * size)
+            unit[i] = i * size + k; // kolumna
+        else
+            unit[i] = ((k / box) * box + i / box) * size + (k % box) * box + i % box; // podkwadrat
+    }
+}
+
+/**
+ * Wypełnia ukryte single - cyfry, które w wierszu, kolumnie lub podkwadracie
+ * pasują tylko do jednego pola
+ * @param p - kontekst propagacji
+ * @return liczba wypełnionych pól lub -1, jeśli któraś cyfra nie ma miejsca w jednostce
+ */
+static int hiddenSingles(Presolver *p) {
+    int size = p->size;
+    int unit[64];
+    int placed = 0;
+
+    for (int u = 0; u < 3 * size; u++) {
+        unitCells(p, u, unit);
+
+        uint64_t used = 0, once = 0, twice = 0;
+        for (int i = 0; i < size; i++) {
+            int val = p->cells[unit[i]];
+            if (val != 0) {
+                used |= (uint64_t)1 << (val - 1);
+            } else {
+                uint64_t mask = p->cand[unit[i]];
+                twice |= once & mask;
+                once |= mask;
+            }
+        }
+        if ((used | once) != p->full)
+            return -1;
+
+        uint64_t hidden = once & ~twice;
+        while (hidden) {
+            uint64_t bit = hidden & -hidden;
+            hidden &= hidden - 1;
+            for (int i = 0; i < size; i++) {
+                if (p->cand[unit[i]] & bit) {
+                    placeDigit(p, unit[i], CTZ(bit) + 1);
+                    placed++;
+                    break;
+                }
+            }
+        }
+    }
+    return placed;
+}
+
+/**
+ * Usuwa kandydatów zablokowanych w wierszach (rowMajor = 1) lub kolumnach (rowMajor = 0).
+ * Wskazywanie: cyfra, która w podkwadracie występuje tylko w jednej linii, nie może stać
+ * w tej linii poza podkwadratem. Przecięcie: cyfra, która w linii występuje tylko w jednym
+ * podkwadracie, nie może stać w tym podkwadracie poza tą linią.
+ * @param p - kontekst propagacji
+ * @param rowMajor - 1 dla wierszy, 0 dla kolumn
+ * @return liczba pól, z których usunięto kandydatów
+ */
+static int lockedLines(Presolver *p, int rowMajor) {
+    int size = p->size, box = p->boxSize;
+    int changed = 0;
+
+    for (int bl = 0; bl < size; bl += box) {
+        // Wskazywanie: podkwadraty w pasie linii bl..bl+box-1
+        for (int bq = 0; bq < size; bq += box) {
+            uint64_t seg[8], once = 0, twice = 0;
+            for (int i = 0; i < box; i++) {
+                seg[i] = 0;
+                for (int j = 0; j < box; j++)
+                    seg[i] |= p->cand[lineCell(p, bl + i, bq + j, rowMajor)];
+                twice |= once & seg[i];
+                once |= seg[i];
+            }
+            uint64_t locked = once & ~twice;
+            for (int i = 0; i < box && locked; i++) {
+                uint64_t bits = seg[i] & locked;
+                if (bits == 0)
+                    continue;
+                for (int q = 0; q < size; q++) {
+                    if (q >= bq && q < bq + box)
+                        continue;
+                    int idx = lineCell(p, bl + i, q, rowMajor);
+                    if (p->cand[idx] & bits) {
+                        p->cand[idx] &= ~bits;
+                        changed++;
+                    }
+                }
+            }
+        }
+
+        // Przecięcie: każda linia pasa dzielona na odcinki po jednym na podkwadrat
+        for (int i = 0; i < box; i++) {
+            int line = bl + i;
+            uint64_t seg[8], once = 0, twice = 0;
+            for (int s = 0; s < box; s++) {
+                seg[s] = 0;
+                for (int j = 0; j < box; j++)
+                    seg[s] |= p->cand[lineCell(p, line, s * box + j, rowMajor)];
+                twice |= once & seg[s];
+                once |= seg[s];
+            }
+            uint64_t locked = once & ~twice;
+            for (int s = 0; s < box && locked; s++) {
+                uint64_t bits = seg[s] & locked;
+                if (bits == 0)
+                    continue;
+                for (int l = bl; l < bl + box; l++) {
+                    if (l == line)
+                        continue;
+                    for (int j = 0; j < box; j++) {
+                        int idx = lineCell(p, l, s * box + j, rowMajor);
+                        if (p->cand[idx] & bits) {
+                            p->cand[idx] &= ~bits;
+                            changed++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+/**
+ * Usuwa kandydatów par: nagich (dwa pola jednostki z tymi samymi dwoma kandydatami
+ * wykluczają te cyfry z reszty jednostki) i ukrytych (dwie cyfry, które w jednostce
+ * mieszczą się tylko w tych samych dwóch polach, wykluczają z nich inne cyfry)
+ * @param p - kontekst propagacji
+ * @return liczba pól, z których usunięto kandydatów
+ */
+static int pairs(Presolver *p) {
+    int size = p->size;
+    int unit[64];
+    int changed = 0;
+
+    for (int u = 0; u < 3 * size; u++) {
+        unitCells(p, u, unit);
+        // Nagie pary
+        for (int i = 0; i < size; i++) {
+            uint64_t mask = p->cand[unit[i]];
+            if (POPCOUNT(mask) != 2)
+                continue;
+            for (int j = i + 1; j < size; j++) {
+                if (p->cand[unit[j]] != mask)
+                    continue;
+                for (int k = 0; k < size; k++) {
+                    if (k != i && k != j && (p->cand[unit[k]] & mask)) {
+                        p->cand[unit[k]] &= ~mask;
+                        changed++;
+                    }
+                }
+            }
+        }
+        // Ukryte pary: where[d] - maska pozycji w jednostce, w których może stać cyfra d + 1
+        uint64_t where[64] = {0};
+        for (int i = 0; i < size; i++) {
+            uint64_t mask = p->cand[unit[i]];
+            while (mask) {
+                where[CTZ(mask)] |= (uint64_t)1 << i;
+                mask &= mask - 1;
+            }
+        }
+        for (int d1 = 0; d1 < size; d1++) {
+            if (POPCOUNT(where[d1]) != 2)
+                continue;
+            for (int d2 = d1 + 1; d2 < size; d2++) {
+                if (where[d2] != where[d1])
+                    continue;
+                uint64_t keep = ((uint64_t)1 << d1) | ((uint64_t)1 << d2);
+                uint64_t cells = where[d1];
+                while (cells) {
+                    int idx = unit[CTZ(cells)];
+                    cells &= cells - 1;
+                    if (p->cand[idx] & ~keep) {
+                        p->cand[idx] &= keep;
+                        changed++;
+                    }
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+/**
+ * Usuwa kandydatów X-wing w wierszach (rowMajor = 1) lub kolumnach (rowMajor = 0):
+ * jeśli cyfra w dwóch liniach może stać tylko na tych samych dwóch pozycjach,
+ * nie może stać na tych pozycjach w żadnej innej linii
+ * @param p - kontekst propagacji
+ * @param rowMajor - 1 dla wierszy, 0 dla kolumn
+ * @return liczba pól, z których usunięto kandydatów
+ */
+static int xWing(Presolver *p, int rowMajor) {
+    int size = p->size;
+    int changed = 0;
+
+    for (int d = 0; d < size; d++) {
+        uint64_t bit = (uint64_t)1 << d;
+        uint64_t where[64];
+        for (int line = 0; line < size; line++) {
+            where[line] = 0;
+            for (int pos = 0; pos < size; pos++)
+                if (p->cand[lineCell(p, line, pos, rowMajor)] & bit)
+                    where[line] |= (uint64_t)1 << pos;
+        }
+        for (int l1 = 0; l1 < size; l1++) {
+            if (POPCOUNT(where[l1]) != 2)
+                continue;
+            for (int l2 = l1 + 1; l2 < size; l2++) {
+                if (where[l2] != where[l1])
+                    continue;
+                for (int line = 0; line < size; line++) {
+                    if (line == l1 || line == l2 || !(where[line] & where[l1]))
+                        continue;
+                    uint64_t cols = where[line] & where[l1];
+                    while (cols) {
+                        p->cand[lineCell(p, line, CTZ(cols), rowMajor)] &= ~bit;
+                        cols &= cols - 1;
+                        changed++;
+                    }
+                    where[line] &= ~where[l1];
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+/**
+ * Stosuje reguły logiczne do wyczerpania: po każdym postępie wraca do najtańszej reguły,
+ * więc trudniejsza reguła jest używana tylko wtedy, gdy łatwiejsze nic nie dają
+ * @param p - kontekst propagacji
+ * @param maxGrade - najtrudniejsza dozwolona reguła (GRADE_*)
+ * @param hardest - wynik: najtrudniejsza reguła, która coś zmieniła (może być NULL)
+ * @return 0 po wyczerpaniu reguł, -1 jeśli plansza jest sprzeczna
+ */
+static int propagate(Presolver *p, int maxGrade, int *hardest) {
+    int used = GRADE_SINGLES;
+    while (1) {
+        int progress = nakedSingles(p);
+        int grade = GRADE_SINGLES;
+        if (progress == 0)
+            progress = hiddenSingles(p);
+        if (progress == 0 && maxGrade >= GRADE_LOCKED) {
+            progress = lockedLines(p, 1) + lockedLines(p, 0);
+            grade = GRADE_LOCKED;
+        }
+        if (progress == 0 && maxGrade >= GRADE_PAIRS) {
+            progress = pairs(p);
+            grade = GRADE_PAIRS;
+        }
+        if (progress == 0 && maxGrade >= GRADE_XWING) {
+            progress = xWing(p, 1) + xWing(p, 0);
+            grade = GRADE_XWING;
+        }
+        if (progress < 0)
+            return -1;
+        if (progress == 0)
+            break;
+        if (grade > used)
+            used = grade;
+    }
+    if (hardest != NULL)
+        *hardest = used;
+    return 0;
+}
+
+/**
+ * Wypełnia pola wymuszone przez ograniczenia i oznacza je jako stałe
+ * @param board - plansza z polami stałymi; wymuszone pola zostaną wypełnione
+ * @return liczba wypełnionych pól lub -1, jeśli plansza jest sprzeczna
+ */
+int presolveBoard(Board *board) {
+    Presolver p;
+    int result = -1;
+
+    if (initPresolver(&p, board) && propagate(&p, GRADE_LOCKED, NULL) == 0)
+        result = p.filled;
+
+    if (result > 0) {
+        int n = board->size * board->size;
+        for (int idx = 0; idx < n; idx++) {
+            if (p.cells[idx] != 0 && !isFixedCell(board, idx)) {
+                board->cells[idx] = p.cells[idx];
+                setFixedCell(board, idx, 1);
+            }
+        }
+    }
+    free(p.cells);
+    free(p.cand);
+    return result;
+}
+
+/**
+ * Ocenia trudność zagadki, rozwiązując ją wyłącznie regułami logicznymi
+ * @param board - zagadka z polami stałymi (nie jest modyfikowana)
+ * @return najtrudniejsza potrzebna reguła (GRADE_*), GRADE_GUESSING gdy reguły
+ *         nie wystarczają, -1 dla planszy sprzecznej
+ */
+int gradeBoard(const Board *board) {
+    Presolver p;
+    int grade = -1;
+
+    if (initPresolver(&p, board) && propagate(&p, GRADE_XWING, &grade) == 0) {
+        if (memchr(p.cells, 0, board->size * board->size) != NULL)
+            grade = GRADE_GUESSING;
+    } else {
+        grade = -1;
+    }
+    free(p.cells);
+    free(p.cand);
+    return grade;
+}
+
+/**
+ * Zwraca polską nazwę poziomu trudności
+ * @param grade - poziom (GRADE_*)
+ * @return nazwa poziomu
+ */
+const char *gradeName(int grade) {
+    switch (grade) {
+    case GRADE_SINGLES: return "łatwa";
+    case GRADE_LOCKED: return "średnia";
+    case GRADE_PAIRS: return "trudna";
+    case GRADE_XWING: return "bardzo trudna";
+    case GRADE_GUESSING: return "ekstremalna";
+    default: return "sprzeczna";
+    }
+}
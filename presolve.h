@@ -0,0 +1,46 @@
+/**
+ * Deklaracja wstępnego rozwiązywania planszy przez propagację ograniczeń.
+ * Przed wyżarzaniem wypełniane są wszystkie pola, których wartość wynika wprost
+ * z reguł (nagie i ukryte single, zablokowani kandydaci), dzięki czemu SA losuje
+ * ruchy tylko wśród pól naprawdę niepewnych, a łatwe zagadki są rozwiązywane od razu.
+ */
+#ifndef PRESOLVE_H
+#define PRESOLVE_H
+
+#include "board.h"
+
+// Poziomy trudności: najtrudniejsza reguła potrzebna do rozwiązania zagadki
+#define GRADE_SINGLES 1 // nagie i ukryte single
+#define GRADE_LOCKED 2 // zablokowani kandydaci (wskazywanie i przecięcie)
+#define GRADE_PAIRS 3 // nagie i ukryte pary
+#define GRADE_XWING 4 // X-wing w wierszach i kolumnach
+#define GRADE_GUESSING 5 // reguły nie wystarczają - potrzebne zgadywanie
+
+/**
+ * Wypełnia pola wymuszone przez ograniczenia i oznacza je jako stałe.
+ * Stosowane są na przemian: nagie single (pole z jednym kandydatem), ukryte single
+ * (cyfra z jednym miejscem w jednostce) oraz zablokowani kandydaci (cyfra w podkwadracie
+ * ograniczona do jednego wiersza/kolumny i odwrotnie), aż żadna reguła nic nie zmieni.
+ * @param board - plansza z polami stałymi; wymuszone pola zostaną wypełnione
+ * @return liczba wypełnionych pól lub -1, jeśli plansza jest sprzeczna
+ */
+int presolveBoard(Board *board);
+
+/**
+ * Ocenia trudność zagadki tak, jak rozwiązywałby ją człowiek: reguły stosowane są
+ * od najłatwiejszej, a trudniejsza reguła tylko wtedy, gdy łatwiejsze nic nie dają.
+ * Wynikiem jest najtrudniejsza użyta reguła.
+ * @param board - zagadka z polami stałymi (nie jest modyfikowana)
+ * @return GRADE_SINGLES .. GRADE_XWING, GRADE_GUESSING gdy reguły nie wystarczają,
+ *         -1 dla planszy sprzecznej
+ */
+int gradeBoard(const Board *board);
+
+/**
+ * Zwraca nazwę poziomu trudności do wyświetlenia
+ * @param grade - poziom (GRADE_*)
+ * @return nazwa poziomu
+ */
+const char *gradeName(int grade);
+
+#endif
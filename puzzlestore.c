@@ -0,0 +1,421 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "puzzlestore.h"
+#include "bitsolver.h"
+
+typedef struct {
+    uint8_t *data; // rekordy sekcji
+    size_t len; // długość danych
+    size_t capacity; // pojemność bufora
+    long count; // liczba rekordów
+} SectionBuffer;
+
+/**
+ * Zwraca liczbę bitów potrzebną do zapisania wartości pola (wartość - 1)
+ * @param size - rozmiar planszy
+ */
+static int valueBits(int size) {
+    int bits = 1;
+    while ((1 << bits) < size)
+        bits++;
+    return bits;
+}
+
+/**
+ * Zwraca rozmiar rekordu planszy size x size: bitset pól stałych i spakowane
+ * rozwiązanie, zaokrąglone do 8 bajtów
+ * @param size - rozmiar planszy
+ */
+static size_t recordSize(int size) {
+    int n = size * size;
+    size_t fixedBytes = (size_t)(n + 63) / 64 * sizeof(uint64_t);
+    size_t packedBytes = ((size_t)n * valueBits(size) + 7) / 8;
+    return (fixedBytes + packedBytes + 7) & ~(size_t)7;
+}
+
+/**
+ * Pakuje pełne rozwiązanie po bits bitów na pole
+ * @param dest - bufor wyjściowy (wyzerowany)
+ * @param cells - komórki rozwiązania (1 .. size)
+ * @param n - liczba pól
+ * @param bits - liczba bitów na pole
+ */
+static void packCells(uint8_t *dest, const uint8_t *cells, int n, int bits) {
+    for (int idx = 0; idx < n; idx++) {
+        int pos = idx * bits;
+        unsigned val = (unsigned)(cells[idx] - 1) << (pos & 7);
+        dest[pos >> 3] |= (uint8_t)val;
+        if ((pos & 7) + bits > 8)
+            dest[(pos >> 3) + 1] |= (uint8_t)(val >> 8);
+    }
+}
+
+/**
+ * Rozpakowuje rozwiązanie zapisane przez packCells
+ * @param cells - komórki wyjściowe
+ * @param src - spakowane dane
+ * @param n - liczba pól
+ * @param bits - liczba bitów na pole
+ */
+static void unpackCells(uint8_t *cells, const uint8_t *src, int n, int bits) {
+    unsigned mask = (1u << bits) - 1;
+    if (bits == 4) {
+        // Najczęstszy przypadek (9x9 i 16x16): dwa pola w bajcie
+        for (int idx = 0; idx < n; idx++)
+            cells[idx] = (uint8_t)(((src[idx >> 1] >> ((idx & 1) * 4)) & mask) + 1);
+        return;
+    }
+    for (int idx = 0; idx < n; idx++) {
+        int pos = idx * bits;
+        unsigned word = src[pos >> 3];
+        if ((pos & 7) + bits > 8)
+            word |= (unsigned)src[(pos >> 3) + 1] << 8;
+        cells[idx] = (uint8_t)(((word >> (pos & 7)) & mask) + 1);
+    }
+}
+
+/**
+ * Otwiera magazyn zagadek (mmap) i sprawdza poprawność nagłówka i sekcji
+ * @param path - ścieżka pliku
+ * @return magazyn lub NULL w przypadku błędu
+ */
+PuzzleStore *openPuzzleStore(const char *path) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+    size_t length = (size_t)st.st_size;
+    if (length < sizeof(StoreHeader)) {
+        fprintf(stderr, "%s: to nie jest magazyn zagadek\n", path);
+        close(fd);
+        return NULL;
+    }
+    const uint8_t *data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // mapowanie pozostaje ważne po zamknięciu deskryptora
+    if (data == MAP_FAILED) {
+        perror(path);
+        return NULL;
+    }
+
+    const StoreHeader *header = (const StoreHeader *)data;
+    const StoreSection *sections = (const StoreSection *)(header + 1);
+    const char *error = NULL;
+    if (memcmp(header->magic, STORE_MAGIC, sizeof(header->magic)) != 0)
+        error = "to nie jest magazyn zagadek";
+    else if (header->version != STORE_VERSION)
+        error = "nieobsługiwana wersja magazynu";
+    else if (header->sectionCount > (length - sizeof(StoreHeader)) / sizeof(StoreSection))
+        error = "uszkodzona tablica sekcji";
+
+    PuzzleStore *store = calloc(1, sizeof(PuzzleStore));
+    // Rekordy sekcji leżą za nagłówkiem i tablicą sekcji
+    uint64_t tableEnd = error == NULL ? sizeof(StoreHeader) + (uint64_t)header->sectionCount * sizeof(StoreSection) : 0;
+    for (uint32_t s = 0; error == NULL && s < header->sectionCount; s++) {
+        const StoreSection *section = &sections[s];
+        int box = boardBoxSize((int)section->size);
+        if (box == 0 || section->grade < GRADE_SINGLES || section->grade > GRADE_GUESSING
+            || section->recordSize != recordSize((int)section->size) || section->offset % 8 != 0
+            || section->offset < tableEnd || section->offset > length
+            || section->count > (length - section->offset) / section->recordSize
+            || section->count > UINT32_MAX || store->index[box][section->grade] != NULL)
+            error = "uszkodzona sekcja magazynu";
+        else
+            store->index[box][section->grade] = section;
+    }
+    if (error != NULL) {
+        fprintf(stderr, "%s: %s\n", path, error);
+        munmap((void *)data, length);
+        free(store);
+        return NULL;
+    }
+    madvise((void *)data, length, MADV_RANDOM); // zagadki pobierane są pojedynczo z losowych miejsc
+    store->data = data;
+    store->length = length;
+    return store;
+}
+
+/**
+ * Zamyka magazyn i zwalnia mapowanie
+ * @param store - magazyn
+ */
+void closePuzzleStore(PuzzleStore *store) {
+    munmap((void *)store->data, store->length);
+    free(store);
+}
+
+/**
+ * Zwraca sekcję danego rozmiaru i oceny
+ * @return sekcja lub NULL
+ */
+static const StoreSection *findSection(const PuzzleStore *store, int size, int grade) {
+    int box = boardBoxSize(size);
+    if (box == 0 || grade < GRADE_SINGLES || grade > GRADE_GUESSING)
+        return NULL;
+    return store->index[box][grade];
+}
+
+/**
+ * Zwraca liczbę zagadek danego rozmiaru i oceny
+ * @param store - magazyn
+ * @param size - rozmiar planszy
+ * @param grade - ocena (GRADE_*)
+ * @return liczba zagadek (0, jeśli sekcji nie ma)
+ */
+long storedPuzzleCount(const PuzzleStore *store, int size, int grade) {
+    const StoreSection *section = findSection(store, size, grade);
+    return section != NULL ? (long)section->count : 0;
+}
+
+/**
+ * Wczytuje zagadkę o podanym numerze
+ * @param store - magazyn
+ * @param grade - ocena (GRADE_*)
+ * @param index - numer zagadki w sekcji
+ * @param puzzle - plansza na zagadkę
+ * @param solution - plansza na rozwiązanie (może być NULL)
+ * @return 0 w przypadku powodzenia, -1 gdy zagadki nie ma w magazynie, -2 dla uszkodzonego rekordu
+ */
+int loadStoredPuzzle(const PuzzleStore *store, int grade, long index, Board *puzzle, Board *solution) {
+    const StoreSection *section = findSection(store, puzzle->size, grade);
+    if (section == NULL || index < 0 || (uint64_t)index >= section->count)
+        return -1;
+    int n = puzzle->size * puzzle->size;
+    size_t fixedBytes = (size_t)(n + 63) / 64 * sizeof(uint64_t);
+    const uint8_t *record = store->data + section->offset + (size_t)index * section->recordSize;
+
+    // Cyfry sprawdzane są przed zapisem na planszę - wartość większa od size wyszłaby poza tablice solverów
+    uint8_t cells[MAX_SIZE * MAX_SIZE];
+    unpackCells(cells, record + fixedBytes, n, valueBits(puzzle->size));
+    for (int idx = 0; idx < n; idx++)
+        if (cells[idx] > puzzle->size)
+            return -2;
+    memcpy(puzzle->fixed, record, fixedBytes);
+    memcpy(puzzle->cells, cells, n);
+    if (solution != NULL)
+        copyBoard(puzzle, solution);
+    for (int idx = 0; idx < n; idx++)
+        if (!isFixedCell(puzzle, idx))
+            puzzle->cells[idx] = 0;
+    return 0;
+}
+
+/**
+ * Wczytuje losową zagadkę danej oceny
+ * @param store - magazyn
+ * @param grade - ocena (GRADE_*)
+ * @param rng - generator liczb losowych
+ * @param puzzle - plansza na zagadkę
+ * @param solution - plansza na rozwiązanie (może być NULL)
+ * @return 0 w przypadku powodzenia, -1 gdy sekcja jest pusta, -2 dla uszkodzonego rekordu
+ */
+int pickStoredPuzzle(const PuzzleStore *store, int grade, Rng *rng, Board *puzzle, Board *solution) {
+    long count = storedPuzzleCount(store, puzzle->size, grade);
+    if (count == 0)
+        return -1;
+    long index = (long)rngBounded(rng, (uint32_t)count); // openPuzzleStore odrzuca sekcje ponad UINT32_MAX zagadek
+    return loadStoredPuzzle(store, grade, index, puzzle, solution);
+}
+
+/**
+ * Wypisuje spis sekcji magazynu
+ * @param store - magazyn
+ * @param out - strumień wyjściowy
+ */
+void describePuzzleStore(const PuzzleStore *store, FILE *out) {
+    fprintf(out, "Rozmiar  Ocena     Zagadki  Bajty/zagadkę  Opis\n");
+    for (int box = MIN_BOX_SIZE; box <= MAX_BOX_SIZE; box++) {
+        for (int grade = GRADE_SINGLES; grade <= GRADE_GUESSING; grade++) {
+            const StoreSection *section = store->index[box][grade];
+            if (section == NULL)
+                continue;
+            fprintf(out, "%2dx%-2d    L%d    %10llu  %13u  %s\n", box * box, box * box, grade,
+                    (unsigned long long)section->count, section->recordSize, gradeName(grade));
+        }
+    }
+}
+
+/**
+ * Dopisuje rekord zagadki do bufora sekcji
+ * @param section - bufor sekcji
+ * @param puzzle - zagadka (pola stałe oznaczone)
+ * @param solution - pełne rozwiązanie
+ * @return 1 w przypadku powodzenia, 0 gdy zabrakło pamięci (bufor bez zmian)
+ */
+static int appendRecord(SectionBuffer *section, const Board *puzzle, const Board *solution) {
+    int n = puzzle->size * puzzle->size;
+    size_t size = recordSize(puzzle->size);
+    if (section->len + size > section->capacity) {
+        size_t capacity = section->capacity;
+        while (section->len + size > capacity)
+            capacity = capacity ? capacity * 2 : 64 * 1024;
+        uint8_t *data = realloc(section->data, capacity);
+        if (data == NULL)
+            return 0;
+        section->data = data;
+        section->capacity = capacity;
+    }
+    uint8_t *record = section->data + section->len;
+    size_t fixedBytes = (size_t)(n + 63) / 64 * sizeof(uint64_t);
+    memset(record, 0, size);
+    memcpy(record, puzzle->fixed, fixedBytes);
+    packCells(record + fixedBytes, solution->cells, n, valueBits(puzzle->size));
+    section->len += size;
+    section->count++;
+    return 1;
+}
+
+/**
+ * Ocenia jedną zagadkę tekstową i dopisuje ją do odpowiedniej sekcji
+ * @param sections - bufory sekcji [podkwadrat][ocena]
+ * @param boards - plansze robocze dla każdego rozmiaru podkwadratu (alokowane przy pierwszym użyciu)
+ * @param text - znaki zagadki
+ * @param len - liczba znaków
+ * @return 1 gdy zagadka została dodana, 0 gdy została pominięta, -1 gdy zabrakło pamięci
+ */
+static int addPuzzle(SectionBuffer sections[][GRADE_GUESSING + 1], Board *boards[][2], const char *text, size_t len) {
+    int size = 1;
+    while ((size_t)(size * size) < len && size <= MAX_SIZE)
+        size++;
+    int box = boardBoxSize(size);
+    if ((size_t)(size * size) != len || box == 0)
+        return 0;
+    if (boards[box][0] == NULL) {
+        boards[box][0] = allocateBoard(size);
+        boards[box][1] = allocateBoard(size);
+    }
+    Board *puzzle = boards[box][0];
+    Board *solution = boards[box][1];
+    for (int idx = 0; idx < (int)len; idx++) {
+        int val = charToCell(text[idx]);
+        if (val < 0 || val > size)
+            return 0;
+        puzzle->cells[idx] = (uint8_t)val;
+        setFixedCell(puzzle, idx, val != 0);
+    }
+    if (countSolutions(puzzle, 2) != 1)
+        return 0; // magazyn zawiera tylko zagadki jednoznaczne
+    int grade = gradeBoard(puzzle);
+    copyBoard(puzzle, solution);
+    if (grade < GRADE_SINGLES || solveExact(solution, NULL) != 1)
+        return 0;
+    return appendRecord(&sections[box][grade], puzzle, solution) ? 1 : -1;
+}
+
+/**
+ * Buduje magazyn z plików tekstowych
+ * @param output - ścieżka pliku magazynu
+ * @param inputs - ścieżki plików z zagadkami
+ * @param inputCount - liczba plików
+ * @return 0 w przypadku powodzenia, 1 w przypadku błędu
+ */
+int buildPuzzleStore(const char *output, char **inputs, int inputCount) {
+    SectionBuffer sections[MAX_BOX_SIZE + 1][GRADE_GUESSING + 1];
+    Board *boards[MAX_BOX_SIZE + 1][2];
+    memset(sections, 0, sizeof(sections));
+    memset(boards, 0, sizeof(boards));
+    long added = 0, skipped = 0;
+    int failed = 0;
+
+    char *line = NULL;
+    size_t capacity = 0;
+    for (int f = 0; f < inputCount && !failed; f++) {
+        FILE *in = fopen(inputs[f], "r");
+        if (in == NULL) {
+            perror(inputs[f]);
+            failed = 1;
+            break;
+        }
+        ssize_t got;
+        while ((got = getline(&line, &capacity, in)) >= 0) {
+            size_t start = strspn(line, " \t");
+            size_t len = strcspn(line + start, " \t\r\n");
+            if (len == 0)
+                continue;
+            int result = addPuzzle(sections, boards, line + start, len);
+            if (result < 0) {
+                fprintf(stderr, "%s: brak pamięci na rekordy magazynu\n", output);
+                failed = 1;
+                break;
+            }
+            if (result > 0)
+                added++;
+            else
+                skipped++;
+        }
+        fclose(in);
+    }
+    free(line);
+
+    // Nagłówek, tablica sekcji i rekordy sekcji w kolejności rozmiaru i oceny
+    StoreHeader header;
+    memcpy(header.magic, STORE_MAGIC, sizeof(header.magic));
+    header.version = STORE_VERSION;
+    header.sectionCount = 0;
+    StoreSection table[(MAX_BOX_SIZE + 1) * (GRADE_GUESSING + 1)];
+    uint64_t offset = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int box = MIN_BOX_SIZE; box <= MAX_BOX_SIZE; box++) {
+            for (int grade = GRADE_SINGLES; grade <= GRADE_GUESSING; grade++) {
+                if (sections[box][grade].count == 0)
+                    continue;
+                if (pass == 0) {
+                    header.sectionCount++;
+                    continue;
+                }
+                StoreSection *section = &table[header.sectionCount++];
+                memset(section, 0, sizeof(*section));
+                section->size = (uint32_t)(box * box);
+                section->grade = (uint32_t)grade;
+                section->recordSize = (uint32_t)recordSize(box * box);
+                section->offset = offset;
+                section->count = (uint64_t)sections[box][grade].count;
+                offset += sections[box][grade].len;
+            }
+        }
+        if (pass == 0) {
+            offset = sizeof(StoreHeader) + header.sectionCount * sizeof(StoreSection);
+            header.sectionCount = 0;
+        }
+    }
+
+    if (!failed) {
+        FILE *out = fopen(output, "wb");
+        if (out == NULL) {
+            perror(output);
+            failed = 1;
+        } else {
+            // Krótki zapis (np. brak miejsca na dysku) nie może zostawić obciętego magazynu
+            int written = fwrite(&header, sizeof(header), 1, out) == 1
+                          && fwrite(table, sizeof(StoreSection), header.sectionCount, out) == header.sectionCount;
+            for (int box = MIN_BOX_SIZE; box <= MAX_BOX_SIZE && written; box++)
+                for (int grade = GRADE_SINGLES; grade <= GRADE_GUESSING && written; grade++)
+                    if (sections[box][grade].len > 0)
+                        written = fwrite(sections[box][grade].data, 1, sections[box][grade].len, out)
+                                  == sections[box][grade].len;
+            if (fclose(out) != 0 || !written) {
+                perror(output);
+                failed = 1;
+            }
+        }
+    }
+    if (!failed)
+        printf("Zapisano %ld zagadek (pominięto %ld) w %u sekcjach do %s\n", added, skipped, header.sectionCount, output);
+
+    for (int box = 0; box <= MAX_BOX_SIZE; box++) {
+        for (int grade = 0; grade <= GRADE_GUESSING; grade++)
+            free(sections[box][grade].data);
+        if (boards[box][0] != NULL) {
+            freeBoard(boards[box][0]);
+            freeBoard(boards[box][1]);
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,111 @@
+/**
+ * Deklaracja binarnego magazynu gotowych zagadek. Plik jest mapowany do pamięci,
+ * a zagadki są pogrupowane w sekcje według rozmiaru planszy i oceny logicznej
+ * (GRADE_* z presolve.h). Wszystkie rekordy sekcji mają stały rozmiar, więc
+ * wylosowanie zagadki to jedno przeliczenie adresu - bez generowania planszy.
+ *
+ * Układ pliku (kolejność bajtów maszyny, przesunięcia wyrównane do 8 bajtów):
+ *   StoreHeader, tablica StoreSection[sectionCount], rekordy kolejnych sekcji.
+ * Rekord: bitset pól stałych (słowa 64-bitowe jak w Board) i rozwiązanie spakowane
+ * po ceil(log2(size)) bitów na pole (wartość - 1; 4 bity dla 9x9 i 16x16).
+ * Zagadka to pola rozwiązania oznaczone w bitsecie, więc nie jest zapisywana osobno.
+ */
+#ifndef PUZZLESTORE_H
+#define PUZZLESTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+#include "rng.h"
+#include "presolve.h"
+
+#define STORE_MAGIC "SUDOKUPS" // 8 bajtów na początku pliku
+#define STORE_VERSION 1 // wersja formatu
+
+typedef struct {
+    char magic[8]; // STORE_MAGIC
+    uint32_t version; // STORE_VERSION
+    uint32_t sectionCount; // liczba sekcji w tablicy za nagłówkiem
+} StoreHeader;
+
+typedef struct {
+    uint32_t size; // rozmiar planszy
+    uint32_t grade; // ocena logiczna zagadek sekcji (GRADE_SINGLES .. GRADE_GUESSING)
+    uint32_t recordSize; // liczba bajtów jednego rekordu
+    uint32_t reserved; // zawsze 0
+    uint64_t offset; // przesunięcie pierwszego rekordu od początku pliku
+    uint64_t count; // liczba rekordów
+} StoreSection;
+
+typedef struct {
+    const uint8_t *data; // zmapowany plik
+    size_t length; // długość pliku
+    const StoreSection *index[MAX_BOX_SIZE + 1][GRADE_GUESSING + 1]; // sekcja dla [podkwadrat][ocena] lub NULL
+} PuzzleStore;
+
+/**
+ * Otwiera magazyn zagadek (mmap) i sprawdza poprawność nagłówka i sekcji
+ * @param path - ścieżka pliku
+ * @return magazyn lub NULL w przypadku błędu (opis wypisywany na stderr)
+ */
+PuzzleStore *openPuzzleStore(const char *path);
+
+/**
+ * Zamyka magazyn i zwalnia mapowanie
+ * @param store - magazyn
+ */
+void closePuzzleStore(PuzzleStore *store);
+
+/**
+ * Zwraca liczbę zagadek danego rozmiaru i oceny
+ * @param store - magazyn
+ * @param size - rozmiar planszy
+ * @param grade - ocena (GRADE_*)
+ * @return liczba zagadek (0, jeśli sekcji nie ma)
+ */
+long storedPuzzleCount(const PuzzleStore *store, int size, int grade);
+
+/**
+ * Wczytuje zagadkę o podanym numerze
+ * @param store - magazyn
+ * @param grade - ocena (GRADE_*); rozmiar planszy wynika z puzzle->size
+ * @param index - numer zagadki w sekcji (0 .. storedPuzzleCount - 1)
+ * @param puzzle - plansza na zagadkę (pola stałe oznaczone, pozostałe puste)
+ * @param solution - plansza na rozwiązanie (może być NULL)
+ * @return 0 w przypadku powodzenia, -1 gdy zagadki nie ma w magazynie, -2 gdy rekord zawiera
+ *         cyfrę większą od rozmiaru planszy (plansze pozostają wtedy bez zmian)
+ */
+int loadStoredPuzzle(const PuzzleStore *store, int grade, long index, Board *puzzle, Board *solution);
+
+/**
+ * Wczytuje losową zagadkę danej oceny - w czasie stałym, bez generowania
+ * @param store - magazyn
+ * @param grade - ocena (GRADE_*); rozmiar planszy wynika z puzzle->size
+ * @param rng - generator liczb losowych
+ * @param puzzle - plansza na zagadkę
+ * @param solution - plansza na rozwiązanie (może być NULL)
+ * @return 0 w przypadku powodzenia, -1 gdy sekcja jest pusta, -2 dla uszkodzonego rekordu
+ */
+int pickStoredPuzzle(const PuzzleStore *store, int grade, Rng *rng, Board *puzzle, Board *solution);
+
+/**
+ * Wypisuje spis sekcji magazynu (rozmiar, ocena, liczba zagadek, bajty na rekord)
+ * @param store - magazyn
+ * @param out - strumień wyjściowy
+ */
+void describePuzzleStore(const PuzzleStore *store, FILE *out);
+
+/**
+ * Buduje magazyn z plików tekstowych. Z każdej linii brane jest pierwsze słowo
+ * (jak w trybie rozwiązywania pliku), więc można podać wprost wynik trybu wsadowego.
+ * Zagadki bez jednoznacznego rozwiązania lub nieprawidłowe są pomijane; rozwiązanie
+ * wyznacza solver bitowy, a ocenę gradeBoard.
+ * @param output - ścieżka pliku magazynu
+ * @param inputs - ścieżki plików z zagadkami
+ * @param inputCount - liczba plików
+ * @return 0 w przypadku powodzenia, 1 w przypadku błędu
+ */
+int buildPuzzleStore(const char *output, char **inputs, int inputCount);
+
+#endif
@@ -0,0 +1,36 @@
+#include "rng.h"
+
+/**
+ * Krok generatora splitmix64 - służy do rozwinięcia ziarna w pełny stan
+ * @param x - stan splitmix64
+ * @return kolejna liczba
+ */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Inicjalizuje generator z ziarna
+ * @param rng - generator
+ * @param seed - ziarno
+ */
+void rngSeed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = splitmix64(&seed);
+}
+
+/**
+ * Inicjalizuje generator dla strumienia wyprowadzonego z ziarna bazowego
+ * @param rng - generator
+ * @param seed - ziarno bazowe
+ * @param stream - numer strumienia
+ */
+void rngSeedStream(Rng *rng, uint64_t seed, uint64_t stream) {
+    uint64_t mix = seed;
+    uint64_t base = splitmix64(&mix);
+    mix = stream;
+    rngSeed(rng, base ^ splitmix64(&mix));
+}
@@ -0,0 +1,74 @@
+/**
+ * Deklaracja szybkiego generatora liczb pseudolosowych (xoshiro256**).
+ * Każdy wątek (łańcuch SA, wątek roboczy) ma własny stan, więc generator
+ * nie wymaga blokad, a podanie tego samego ziarna daje powtarzalne wyniki.
+ */
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4]; // stan generatora
+} Rng;
+
+/**
+ * Inicjalizuje generator z ziarna (stan rozwijany przez splitmix64)
+ * @param rng - generator
+ * @param seed - ziarno
+ */
+void rngSeed(Rng *rng, uint64_t seed);
+
+/**
+ * Inicjalizuje generator dla strumienia numer stream wyprowadzonego z ziarna bazowego.
+ * Różne strumienie (wątki, łańcuchy, numery zagadek) dają niezależne ciągi liczb.
+ * @param rng - generator
+ * @param seed - ziarno bazowe
+ * @param stream - numer strumienia
+ */
+void rngSeedStream(Rng *rng, uint64_t seed, uint64_t stream);
+
+/**
+ * Zwraca kolejną 64-bitową liczbę losową
+ */
+static inline uint64_t rngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t x = s[1] * 5;
+    uint64_t result = ((x << 7) | (x >> 57)) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+
+/**
+ * Zwraca liczbę losową z przedziału [0, bound) bez obciążenia modulo
+ * (mnożenie 32x32 -> 64 bity z odrzucaniem, metoda Lemire'a)
+ * @param rng - generator
+ * @param bound - górna granica (większa od 0)
+ */
+static inline uint32_t rngBounded(Rng *rng, uint32_t bound) {
+    uint64_t m = (uint64_t)(uint32_t)(rngNext(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (uint64_t)(uint32_t)(rngNext(rng) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/**
+ * Zwraca liczbę losową z przedziału [0, 1)
+ */
+static inline double rngDouble(Rng *rng) {
+    return (rngNext(rng) >> 11) * 0x1.0p-53;
+}
+
+#endif
@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "server.h"
+#include "board.h"
+#include "solvercontext.h"
+
+#define SERVER_QUEUE_CAPACITY 1024 // maksymalna liczba żądań czekających na wątki robocze
+#define SERVER_LINE_MAX 4096 // maksymalna długość linii żądania (z zapasem na planszę 36x36)
+#define SERVER_SA_ITERATIONS 2000000 // limit iteracji wyżarzania na jedno żądanie
+
+typedef struct {
+    int fd; // gniazdo połączenia
+    pthread_mutex_t writeMutex; // chroni zapis odpowiedzi (całe linie od różnych wątków)
+    atomic_int refs; // wątek czytający + żądania w toku; połączenie zamykane przy zerze
+} Connection;
+
+typedef struct {
+    Connection *conn; // połączenie, na które trzeba odpowiedzieć
+    char *line; // treść żądania (bez znaku nowej linii)
+    uint64_t number; // kolejny numer żądania - strumień generatora wyżarzania
+    struct timespec deadline; // termin odpowiedzi liczony od przyjęcia żądania (gdy serwer ma limit czasu)
+} Request;
+
+typedef struct {
+    Request items[SERVER_QUEUE_CAPACITY]; // bufor cykliczny żądań
+    int head; // indeks najstarszego żądania
+    int count; // liczba żądań w kolejce
+    uint64_t nextNumber; // numer następnego przyjętego żądania
+    pthread_mutex_t mutex; // chroni kolejkę
+    pthread_cond_t notEmpty; // sygnalizowane po dodaniu żądania
+    pthread_cond_t notFull; // sygnalizowane po pobraniu żądania
+    uint64_t seed; // ziarno bazowe wyżarzania
+    long timeLimitMs; // limit czasu żądania w milisekundach, łącznie z oczekiwaniem w kolejce (0 - brak)
+} Server;
+
+typedef struct {
+    Server *server; // wspólne dane serwera
+    Connection *conn; // obsługiwane połączenie
+} ReaderArgs;
+
+typedef struct {
+    SolverContext *solver; // plansze i łańcuchy wyżarzania wątku
+    char response[SERVER_LINE_MAX + 16]; // bufor odpowiedzi
+} WorkerContext;
+
+/**
+ * Zwalnia jedno odwołanie do połączenia; ostatnie zamyka gniazdo
+ * @param conn - połączenie
+ */
+static void releaseConnection(Connection *conn) {
+    if (atomic_fetch_sub(&conn->refs, 1) == 1) {
+        close(conn->fd);
+        pthread_mutex_destroy(&conn->writeMutex);
+        free(conn);
+    }
+}
+
+/**
+ * Wysyła całą linię odpowiedzi (zapis niepodzielny względem innych wątków)
+ * @param conn - połączenie
+ * @param data - dane do wysłania
+ * @param len - długość danych
+ */
+static void sendLine(Connection *conn, const char *data, size_t len) {
+    pthread_mutex_lock(&conn->writeMutex);
+    while (len > 0) {
+        ssize_t written = write(conn->fd, data, len);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            break; // klient się rozłączył - odpowiedź przepada
+        data += written;
+        len -= written;
+    }
+    pthread_mutex_unlock(&conn->writeMutex);
+}
+
+/**
+ * Dodaje żądanie do kolejki, czekając gdy kolejka jest pełna
+ * @param server - dane serwera
+ * @param conn - połączenie, z którego przyszło żądanie
+ * @param line - treść żądania (przechodzi na własność kolejki)
+ */
+static void enqueueRequest(Server *server, Connection *conn, char *line) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline); // termin liczony jest od odczytania żądania
+    long nanos = deadline.tv_nsec + server->timeLimitMs % 1000 * 1000000;
+    deadline.tv_sec += server->timeLimitMs / 1000 + nanos / 1000000000;
+    deadline.tv_nsec = nanos % 1000000000;
+    atomic_fetch_add(&conn->refs, 1);
+    pthread_mutex_lock(&server->mutex);
+    while (server->count == SERVER_QUEUE_CAPACITY)
+        pthread_cond_wait(&server->notFull, &server->mutex);
+    Request *req = &server->items[(server->head + server->count) % SERVER_QUEUE_CAPACITY];
+    req->conn = conn;
+    req->line = line;
+    req->number = server->nextNumber++;
+    req->deadline = deadline;
+    server->count++;
+    pthread_cond_signal(&server->notEmpty);
+    pthread_mutex_unlock(&server->mutex);
+}
+
+/**
+ * Pobiera najstarsze żądanie z kolejki, czekając gdy kolejka jest pusta
+ * @param server - dane serwera
+ * @return pobrane żądanie
+ */
+static Request dequeueRequest(Server *server) {
+    pthread_mutex_lock(&server->mutex);
+    while (server->count == 0)
+        pthread_cond_wait(&server->notEmpty, &server->mutex);
+    Request req = server->items[server->head];
+    server->head = (server->head + 1) % SERVER_QUEUE_CAPACITY;
+    server->count--;
+    pthread_cond_signal(&server->notFull);
+    pthread_mutex_unlock(&server->mutex);
+    return req;
+}
+
+/**
+ * Zapisuje odpowiedź "<id> <status> <treść>\n" do bufora kontekstu
+ * @return długość odpowiedzi
+ */
+static size_t formatResponse(WorkerContext *ctx, const char *id, const char *status, const char *text) {
+    int len = snprintf(ctx->response, sizeof(ctx->response), "%s %s %s\n", id, status, text);
+    if (len < 0 || (size_t)len >= sizeof(ctx->response))
+        return sizeof(ctx->response) - 1;
+    return len;
+}
+
+/**
+ * Zapisuje odpowiedź z planszą "<id> <status> <plansza>\n" do bufora kontekstu
+ * @return długość odpowiedzi
+ */
+static size_t formatBoardResponse(WorkerContext *ctx, const char *id, const char *status, const Board *board) {
+    int n = board->size * board->size;
+    char cells[MAX_SIZE * MAX_SIZE + 1];
+    for (int idx = 0; idx < n; idx++)
+        cells[idx] = cellToChar(board->cells[idx]);
+    cells[n] = '\0';
+    return formatResponse(ctx, id, status, cells);
+}
+
+/**
+ * Rozwiązuje jedno żądanie i zapisuje odpowiedź do bufora kontekstu
+ * @param ctx - kontekst solvera wątku
+ * @param server - dane serwera
+ * @param req - żądanie
+ * @return długość odpowiedzi
+ */
+static size_t handleRequest(WorkerContext *ctx, const Server *server, const Request *req) {
+    char *save = NULL;
+    char *id = strtok_r(req->line, " \t", &save);
+    char *method = strtok_r(NULL, " \t", &save);
+    char *puzzle = strtok_r(NULL, " \t", &save);
+    if (id == NULL)
+        id = "-";
+    if (method == NULL || puzzle == NULL)
+        return formatResponse(ctx, id, "ERR", "oczekiwano: <id> <exact|sa|hybrid> <zagadka>");
+    int solveMethod = parseSolveMethod(method);
+    if (solveMethod < 0)
+        return formatResponse(ctx, id, "ERR", "nieznana metoda");
+
+    const char *error = NULL;
+    Board *board = parsePuzzle(ctx->solver, puzzle, strlen(puzzle), &error);
+    if (board == NULL)
+        return formatResponse(ctx, id, "ERR", error);
+
+    int status = solvePuzzle(ctx->solver, board, solveMethod, SERVER_SA_ITERATIONS, server->seed, req->number,
+                             server->timeLimitMs > 0 ? &req->deadline : NULL);
+    if (status == SOLVE_CONTRADICTION)
+        return formatResponse(ctx, id, "ERR", "plansza sprzeczna");
+    if (status == SOLVE_TIMEOUT)
+        return formatBoardResponse(ctx, id, "TIMEOUT", board);
+    return formatBoardResponse(ctx, id, status == SOLVE_OK ? "OK" : "FAIL", board);
+}
+
+/**
+ * Funkcja wątku roboczego: pobiera żądania z kolejki i odsyła odpowiedzi
+ * @param arg - wskaźnik na Server
+ */
+static void *serverWorker(void *arg) {
+    Server *server = arg;
+    WorkerContext *ctx = malloc(sizeof(WorkerContext));
+    ctx->solver = createSolverContext();
+    while (1) {
+        Request req = dequeueRequest(server);
+        size_t len = handleRequest(ctx, server, &req);
+        sendLine(req.conn, ctx->response, len);
+        free(req.line);
+        releaseConnection(req.conn);
+    }
+    return NULL;
+}
+
+/**
+ * Funkcja wątku połączenia: dzieli strumień na linie i wrzuca je do kolejki żądań
+ * @param arg - wskaźnik na ReaderArgs (zwalniany przez wątek)
+ */
+static void *connectionReader(void *arg) {
+    ReaderArgs *args = arg;
+    Server *server = args->server;
+    Connection *conn = args->conn;
+    free(args);
+
+    char buffer[SERVER_LINE_MAX];
+    size_t used = 0;
+    int skipping = 0; // 1 - pomijamy resztę zbyt długiej linii
+    ssize_t got;
+    while ((got = read(conn->fd, buffer + used, sizeof(buffer) - used)) != 0) {
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        used += got;
+        char *start = buffer;
+        char *newline;
+        while ((newline = memchr(start, '\n', buffer + used - start)) != NULL) {
+            size_t len = newline - start;
+            if (len > 0 && start[len - 1] == '\r')
+                len--;
+            if (!skipping && len > 0)
+                enqueueRequest(server, conn, strndup(start, len));
+            skipping = 0;
+            start = newline + 1;
+        }
+        used -= start - buffer;
+        memmove(buffer, start, used);
+        if (used == sizeof(buffer)) {
+            static const char tooLong[] = "- ERR linia za długa\n";
+            sendLine(conn, tooLong, sizeof(tooLong) - 1);
+            skipping = 1;
+            used = 0;
+        }
+    }
+    releaseConnection(conn);
+    return NULL;
+}
+
+/**
+ * Uruchamia serwer na gnieździe Unix i obsługuje połączenia do czasu zabicia procesu
+ * @param path - ścieżka gniazda
+ * @param threads - liczba wątków roboczych
+ * @param seed - ziarno bazowe wyżarzania
+ * @param timeLimitMs - limit czasu żądania w milisekundach (0 - brak)
+ * @return 1 w przypadku błędu uruchomienia
+ */
+int runServer(const char *path, int threads, uint64_t seed, long timeLimitMs) {
+    if (threads < 1) threads = 1;
+    signal(SIGPIPE, SIG_IGN); // zapis do zamkniętego połączenia nie może zabić serwera
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Zbyt długa ścieżka gniazda: %s\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(path);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, 64) < 0) {
+        perror(path);
+        close(listenFd);
+        return 1;
+    }
+
+    Server *server = calloc(1, sizeof(Server));
+    server->seed = seed;
+    server->timeLimitMs = timeLimitMs > 0 ? timeLimitMs : 0;
+    pthread_mutex_init(&server->mutex, NULL);
+    pthread_cond_init(&server->notEmpty, NULL);
+    pthread_cond_init(&server->notFull, NULL);
+    for (int t = 0; t < threads; t++) {
+        pthread_t worker;
+        pthread_create(&worker, NULL, serverWorker, server);
+        pthread_detach(worker);
+    }
+    printf("Serwer nasłuchuje na %s (wątki: %d)\n", path, threads);
+    fflush(stdout);
+
+    while (1) {
+        int fd = accept(listenFd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            perror("accept");
+            break;
+        }
+        Connection *conn = malloc(sizeof(Connection));
+        conn->fd = fd;
+        pthread_mutex_init(&conn->writeMutex, NULL);
+        atomic_init(&conn->refs, 1);
+
+        ReaderArgs *args = malloc(sizeof(ReaderArgs));
+        args->server = server;
+        args->conn = conn;
+        pthread_t reader;
+        pthread_create(&reader, NULL, connectionReader, args);
+        pthread_detach(reader);
+    }
+    close(listenFd);
+    unlink(path);
+    return 1;
+}
@@ -0,0 +1,33 @@
+/**
+ * Deklaracja trybu serwera: długo działający proces rozwiązujący zagadki
+ * przesyłane przez gniazdo Unix. Koszt startu i alokacji płacony jest raz,
+ * a nie przy każdej zagadce.
+ *
+ * Protokół tekstowy, jedna linia na żądanie (wiele żądań na połączenie):
+ *   <id> <metoda> <zagadka>
+ * gdzie metoda to "exact" (solver bitowy), "sa" (propagacja + wyżarzanie) lub "hybrid"
+ * (wyżarzanie dokańczane solverem bitowym - zawsze poprawny wynik),
+ * a zagadka to size*size znaków formatu cellToChar ('.' lub '0' - puste pole).
+ * Odpowiedzi przychodzą w dowolnej kolejności, oznaczone identyfikatorem żądania:
+ *   <id> OK <rozwiązanie>
+ *   <id> FAIL <najlepsza plansza>   (wyżarzanie nie osiągnęło energii 0)
+ *   <id> TIMEOUT <najlepsza plansza>   (minął limit czasu żądania)
+ *   <id> ERR <opis błędu>
+ */
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+
+/**
+ * Uruchamia serwer na gnieździe Unix i obsługuje połączenia do czasu zabicia procesu.
+ * @param path - ścieżka gniazda (istniejący plik gniazda jest usuwany)
+ * @param threads - liczba wątków roboczych
+ * @param seed - ziarno bazowe wyżarzania; żądanie nr i używa strumienia i
+ * @param timeLimitMs - limit czasu żądania w milisekundach liczony od jego odczytania, łącznie
+ *                      z oczekiwaniem w kolejce (0 - brak); po nim wyżarzanie oddaje najlepszą planszę
+ * @return 1 w przypadku błędu uruchomienia
+ */
+int runServer(const char *path, int threads, uint64_t seed, long timeLimitMs);
+
+#endif
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <string.h>
+#include "solvercontext.h"
+#include "bitsolver.h"
+#include "presolve.h"
+
+#define SOLVE_EXACT_SECONDS 10.0 // limit solvera bitowego bez terminu - trudna zagadka nie wstrzymuje wyjścia
+
+/**
+ * Alokuje pusty kontekst; plansze i łańcuchy powstają przy pierwszym użyciu
+ * @return wskaźnik do kontekstu
+ */
+SolverContext *createSolverContext(void) {
+    return calloc(1, sizeof(SolverContext));
+}
+
+/**
+ * Zwalnia kontekst wraz z planszami i łańcuchami
+ * @param ctx - kontekst
+ */
+void freeSolverContext(SolverContext *ctx) {
+    for (int box = 0; box <= MAX_BOX_SIZE; box++) {
+        if (ctx->boards[box] != NULL)
+            freeBoard(ctx->boards[box]);
+        if (ctx->chainReady[box])
+            chain_free(&ctx->chains[box]);
+    }
+    free(ctx);
+}
+
+/**
+ * Przygotowuje łańcuch wyżarzania kontekstu dla planszy - pamięć alokowana jest
+ * tylko przy pierwszej planszy danego rozmiaru, potem łańcuch jest resetowany
+ */
+static SAChain *contextChain(SolverContext *ctx, const Board *board, uint64_t seed, uint64_t stream) {
+    int box = board->box_size;
+    if (!ctx->chainReady[box]) {
+        chain_init(&ctx->chains[box], board, seed, stream);
+        ctx->chainReady[box] = 1;
+    } else {
+        chain_reset(&ctx->chains[box], board, seed, stream);
+    }
+    return &ctx->chains[box];
+}
+
+/**
+ * Zamienia nazwę metody na stałą SOLVE_METHOD_*
+ * @param name - nazwa metody
+ * @return stała metody lub -1 dla nieznanej nazwy
+ */
+int parseSolveMethod(const char *name) {
+    if (strcmp(name, "exact") == 0)
+        return SOLVE_METHOD_EXACT;
+    if (strcmp(name, "sa") == 0)
+        return SOLVE_METHOD_SA;
+    if (strcmp(name, "hybrid") == 0)
+        return SOLVE_METHOD_HYBRID;
+    if (strcmp(name, "batch") == 0)
+        return SOLVE_METHOD_BATCH;
+    return -1;
+}
+
+/**
+ * Wczytuje zagadkę zapisaną znakami cellToChar do planszy roboczej kontekstu
+ * @param ctx - kontekst
+ * @param text - znaki zagadki
+ * @param len - liczba znaków
+ * @param error - miejsce na opis błędu (może być NULL)
+ * @return plansza robocza kontekstu lub NULL, jeśli zagadka jest nieprawidłowa
+ */
+Board *parsePuzzle(SolverContext *ctx, const char *text, size_t len, const char **error) {
+    int size = 1;
+    while ((size_t)(size * size) < len && size <= MAX_SIZE)
+        size++;
+    int box = boardBoxSize(size);
+    if ((size_t)(size * size) != len || box == 0) {
+        if (error != NULL)
+            *error = "nieobsługiwany rozmiar planszy";
+        return NULL;
+    }
+
+    if (ctx->boards[box] == NULL)
+        ctx->boards[box] = allocateBoard(size);
+    Board *board = ctx->boards[box];
+    for (int idx = 0; idx < (int)len; idx++) {
+        int val = charToCell(text[idx]);
+        if (val < 0 || val > size) {
+            if (error != NULL)
+                *error = "nieprawidłowy znak planszy";
+            return NULL;
+        }
+        board->cells[idx] = (uint8_t)val;
+        setFixedCell(board, idx, val != 0);
+    }
+    return board;
+}
+
+/**
+ * Rozwiązuje planszę solverem bitowym w czasie pozostałym do terminu (bez terminu - w SOLVE_EXACT_SECONDS)
+ * @return SOLVE_OK, SOLVE_CONTRADICTION lub SOLVE_TIMEOUT
+ */
+static int solveExactUntil(Board *board, const struct timespec *deadline) {
+    double timeLimit = SOLVE_EXACT_SECONDS;
+    if (deadline != NULL) {
+        timeLimit = -seconds_since(deadline);
+        if (timeLimit <= 0)
+            return SOLVE_TIMEOUT;
+    }
+    int result = solveExactLimited(board, NULL, 0, timeLimit);
+    return result == 1 ? SOLVE_OK : result == 0 ? SOLVE_CONTRADICTION : SOLVE_TIMEOUT;
+}
+
+/**
+ * Rozwiązuje planszę w miejscu
+ * @param ctx - kontekst
+ * @param board - plansza z polami stałymi
+ * @param method - SOLVE_METHOD_EXACT, SOLVE_METHOD_SA, SOLVE_METHOD_HYBRID lub SOLVE_METHOD_BATCH
+ * @param iterations - limit iteracji wyżarzania
+ * @param seed - ziarno bazowe wyżarzania
+ * @param stream - numer strumienia generatora
+ * @param deadline - termin CLOCK_MONOTONIC (NULL - brak)
+ * @return SOLVE_OK, SOLVE_FAIL, SOLVE_CONTRADICTION lub SOLVE_TIMEOUT
+ */
+int solvePuzzle(SolverContext *ctx, Board *board, int method, int iterations, uint64_t seed, uint64_t stream,
+                const struct timespec *deadline) {
+    int n = board->size * board->size;
+    if (method == SOLVE_METHOD_EXACT)
+        return solveExactUntil(board, deadline);
+
+    if (presolveBoard(board) < 0)
+        return SOLVE_CONTRADICTION;
+    if (memchr(board->cells, 0, n) == NULL)
+        return SOLVE_OK;
+    if (method == SOLVE_METHOD_BATCH) {
+        int solved = 0;
+        solve_sudoku_sa_batch(&board, 1, iterations, seed, &stream, &solved);
+        return solved ? SOLVE_OK : SOLVE_FAIL;
+    }
+    SAChain *chain = contextChain(ctx, board, seed, stream);
+    int hybrid = method == SOLVE_METHOD_HYBRID;
+    sa_run_adaptive(chain, board, iterations, NULL, deadline, NULL, hybrid);
+    if (hybrid && chain->best_energy > 0) {
+        int status = solveExactUntil(board, deadline); // gwarancja poprawnego wyniku
+        if (status != SOLVE_TIMEOUT)
+            return status;
+    }
+    memcpy(board->cells, chain->best, n);
+    if (chain->best_energy == 0)
+        return SOLVE_OK;
+    return deadline != NULL && seconds_since(deadline) >= 0 ? SOLVE_TIMEOUT : SOLVE_FAIL;
+}
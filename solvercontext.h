@@ -0,0 +1,78 @@
+/**
+ * Deklaracja kontekstu rozwiązywania pojedynczych zagadek tekstowych, wspólnego
+ * dla trybu serwera i trybu rozwiązywania pliku. Kontekst należy do jednego wątku
+ * i przechowuje plansze robocze oraz łańcuchy wyżarzania dla każdego rozmiaru,
+ * więc kolejne zagadki nie alokują pamięci.
+ */
+#ifndef SOLVERCONTEXT_H
+#define SOLVERCONTEXT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+#include "SA_internal.h"
+
+#define SOLVE_METHOD_EXACT 0 // solver bitowy
+#define SOLVE_METHOD_SA 1 // propagacja ograniczeń + wyżarzanie
+#define SOLVE_METHOD_HYBRID 2 // jak SOLVE_METHOD_SA, plateau dokańczane solverem bitowym
+#define SOLVE_METHOD_BATCH 3 // propagacja ograniczeń + wyżarzanie partiami (solve_sudoku_sa_batch)
+
+#define SOLVE_OK 0 // plansza rozwiązana
+#define SOLVE_FAIL 1 // wyżarzanie nie osiągnęło energii 0 (plansza zawiera najlepszy stan)
+#define SOLVE_CONTRADICTION 2 // plansza sprzeczna
+#define SOLVE_TIMEOUT 3 // minął termin lub domyślny limit solvera bitowego (plansza zawiera najlepszy stan
+                        // wyżarzania lub wejście solvera bitowego)
+
+typedef struct {
+    Board *boards[MAX_BOX_SIZE + 1]; // plansza robocza dla każdego rozmiaru podkwadratu
+    SAChain chains[MAX_BOX_SIZE + 1]; // łańcuch wyżarzania dla każdego rozmiaru podkwadratu
+    int chainReady[MAX_BOX_SIZE + 1]; // 1 gdy chains[n] jest już zaalokowany
+} SolverContext;
+
+/**
+ * Alokuje pusty kontekst; plansze i łańcuchy powstają przy pierwszym użyciu
+ * @return wskaźnik do kontekstu
+ */
+SolverContext *createSolverContext(void);
+
+/**
+ * Zwalnia kontekst wraz z planszami i łańcuchami
+ * @param ctx - kontekst
+ */
+void freeSolverContext(SolverContext *ctx);
+
+/**
+ * Zamienia nazwę metody ("exact", "sa", "hybrid" lub "batch") na stałą SOLVE_METHOD_*
+ * @param name - nazwa metody
+ * @return stała metody lub -1 dla nieznanej nazwy
+ */
+int parseSolveMethod(const char *name);
+
+/**
+ * Wczytuje zagadkę zapisaną znakami cellToChar do planszy roboczej kontekstu.
+ * Znaki są czytane wprost z bufora wejściowego, bez kopiowania.
+ * @param ctx - kontekst
+ * @param text - znaki zagadki (nie musi kończyć się zerem)
+ * @param len - liczba znaków; musi być kwadratem obsługiwanego rozmiaru planszy
+ * @param error - miejsce na opis błędu (może być NULL)
+ * @return plansza robocza kontekstu lub NULL, jeśli zagadka jest nieprawidłowa
+ */
+Board *parsePuzzle(SolverContext *ctx, const char *text, size_t len, const char **error);
+
+/**
+ * Rozwiązuje planszę w miejscu. Pojedyncza plansza metodą SOLVE_METHOD_BATCH to partia
+ * z jedną zagadką - zysk z partii daje dopiero rozwiązywanie wielu zagadek naraz (tryb pliku).
+ * @param ctx - kontekst (plansza musi pochodzić z parsePuzzle tego kontekstu)
+ * @param board - plansza z polami stałymi
+ * @param method - SOLVE_METHOD_EXACT, SOLVE_METHOD_SA, SOLVE_METHOD_HYBRID lub SOLVE_METHOD_BATCH
+ * @param iterations - limit iteracji wyżarzania
+ * @param seed - ziarno bazowe wyżarzania
+ * @param stream - numer strumienia generatora (np. numer zagadki)
+ * @param deadline - termin CLOCK_MONOTONIC dla metod exact, sa i hybrid (NULL - brak; solver bitowy
+ *                   ma wtedy domyślny limit czasu); metoda batch ogranicza tylko limit iteracji
+ * @return SOLVE_OK, SOLVE_FAIL, SOLVE_CONTRADICTION lub SOLVE_TIMEOUT
+ */
+int solvePuzzle(SolverContext *ctx, Board *board, int method, int iterations, uint64_t seed, uint64_t stream,
+                const struct timespec *deadline);
+
+#endif